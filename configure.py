@@ -1,17 +1,23 @@
 #!/usr/bin/env python3
 import glob
+import hashlib
 import io
 import os
 import json
 import sys
 import platform
-from tools.ninja_syntax import Writer, serialize_path
+import re
+import shlex
+import shutil
+import subprocess
+from tools.ninja_syntax import Writer, escape, serialize_path
+from tools.object_cache import hash_headers, include_dirs, object_key, object_path
 from pathlib import Path
 from typing import Any, Dict, List, Optional, Set, Tuple, Union, cast
 
 binutils_tag = "2.42-1"
 compilers_tag = "20250513"
-dtk_tag = "v1.0.0" # currently unused?
+dtk_tag = "v1.0.0"
 objdiff_tag = "v2.7.1"
 sjiswrap_tag = "v1.1.1"
 wibo_tag = "0.6.11"
@@ -29,15 +35,31 @@ target_build_dir = os.path.join(build_dir, "src", "target")
 target_out_dir = os.path.join(out_dir, "src", "target")
 base_build_dir = os.path.join(build_dir, "src", "base")
 base_out_dir = os.path.join(out_dir, "src", "base")
+bench_build_dir = os.path.join(build_dir, "src", "bench")
+bench_out_dir = os.path.join(out_dir, "src", "bench")
+profile_build_dir = os.path.join(build_dir, "src", "profile")
+profile_out_dir = os.path.join(out_dir, "src", "profile")
+native_build_dir = os.path.join(build_dir, "native")
 
 def is_windows() -> bool:
     return os.name == "nt"
 
-# On Windows, we need this to use && in commands
+# On Windows, we need this to use && or redirects in commands
 CHAIN = "cmd /c " if is_windows() else ""
 # Native executable extension
 EXE = ".exe" if is_windows() else ""
 
+# Settings taken from the environment, or from NAME=value arguments, which is
+# how the regeneration edge passes them on
+SETTINGS = ("CC", "NO_PCH", "OBJECT_CACHE")
+settings = {name: os.environ.get(name, "") for name in SETTINGS}
+if __name__ == "__main__":
+    for arg in sys.argv[1:]:
+        name, sep, value = arg.partition("=")
+        if not sep or name not in settings:
+            sys.exit(f"usage: configure.py [{'|'.join(SETTINGS)}=value]...")
+        settings[name] = value
+
 # TODO: Debug?
 RELEASE_MWCC_FLAGS = [
     # System
@@ -66,15 +88,97 @@ BASE_MWCC_FLAGS = \
     f"-Isrc/{base_src_dir}/main_content",
 ]
 
+# Benchmark DOL, built from the answers so timings reflect matching code
+BENCH_MWCC_FLAGS = \
+    TARGET_MWCC_FLAGS + [
+    "-DBENCH",
+]
+
+# Profiling DOL, objects with `profile=True` additionally get PROFILE_HOOK_FLAGS
+PROFILE_MWCC_FLAGS = \
+    TARGET_MWCC_FLAGS + [
+    "-DPROFILE",
+]
+
+# mwcc calls __PROFILE_ENTRY/__PROFILE_EXIT from src/shared/profile.c
+PROFILE_HOOK_FLAGS = [
+    "-profile on",
+]
+
+# Precompile src/runtime/precompiled.h per compiler version and flag set and
+# prefix it to every runtime and shared C object. Set NO_PCH=1 to compare build times without it.
+USE_PCH = settings["NO_PCH"] == ""
+PCH_SOURCE = "runtime/precompiled.h"
+
+# Target objects are looked up in this directory by a hash of their source,
+# headers, flags and compiler version, and copied out instead of compiled when
+# present. `ninja object_cache` adds the ones this tree built. Point
+# OBJECT_CACHE at a directory seeded on a build host to skip compiling the
+# answers on a fresh checkout.
+OBJECT_CACHE = Path(settings["OBJECT_CACHE"] or build_dir / "object_cache")
+
+# Host compiler build of the portable runtime/shared code
+NATIVE_CC = settings["CC"] or "cc"
+# main.dol comes from src/native/elf2dol.c when there is a host compiler (CC
+# set, or cc on PATH) and from `dtk elf2dol` otherwise, e.g. on Windows
+USE_NATIVE_ELF2DOL = bool(settings["CC"]) or shutil.which(NATIVE_CC) is not None
+NATIVE_CFLAGS = [
+    "-O2",
+    "-g",
+    "-fno-builtin",
+    "-Wno-unknown-pragmas",
+    "-Isrc/runtime",
+    "-Isrc/shared",
+    "-Isrc/native",
+    f"-Isrc/{target_src_dir}/main_content",
+]
+# Added for .cpp sources, matching -Cpp_exceptions off so nothing needs the C++ runtime
+NATIVE_CXXFLAGS = [
+    "-fno-exceptions",
+    "-fno-rtti",
+]
+
 # TODO: Debug?
 RELEASE_MWLD_FLAGS = [
     "-fp hard",
     "-nodefaults",
     "-mapunused",
     "-listclosure",
-    "-lcf " + os.path.join("$build_dir", "ldscript.lcf"),
 ]
 
+# Stack sizes patched into build/ldscript.lcf to produce build/main.lcf.
+# `ninja stack` measures the worst case into build/stack_size.json, which
+# replaces the default on the next configure and frees the rest for the arena.
+STACK_SIZE = 0x10000
+DB_STACK_SIZE = 0x2000
+
+# A size that is only a lower bound (recursion, unknown frames) is ignored
+# unless it was written with --force or --min.
+stack_size_json = build_dir / "stack_size.json"
+if stack_size_json.exists():
+    with open(stack_size_json) as f:
+        stack_size = json.load(f)
+    if not stack_size.get("uncertain") or stack_size.get("forced"):
+        STACK_SIZE = stack_size["stack_size"]
+
+# Partial link of a REL module, dtk turns the result into a .rel
+MODULE_MWLD_FLAGS = [
+    "-fp hard",
+    "-nodefaults",
+    "-mapunused",
+    "-r1",
+    "-m _prolog",
+    "-strip_partial",
+    "-lcf " + os.path.join("$build_dir", "partial.lcf"),
+]
+
+# Maximum sizes in bytes checked by `ninja sizes`, per section or "total"
+SIZE_BUDGETS: Dict[str, int] = {
+    ".init": 0x1000,
+    ".text": 0x8000,
+    "total": 0x10000,
+}
+
 class BuildObject:
     def __init__(self, path: str, should_diff: bool, **options: Any) -> None:
         self.name = os.path.splitext(path)[0]
@@ -92,18 +196,132 @@ class BuildObject:
             self.base_obj = self.name + ".o"
         self.options: Dict[str, Any] = {
             "mw_version": "GC/1.2.5n",
+            # Name of the REL module to link this object into instead of main.elf
+            "module": None,
+            # Instrument with entry/exit hooks in the profiling DOL
+            "profile": False,
+            # Use the precompiled headers (C sources only). Lessons are left
+            # out so they see only what they include, like in tools/grade.py,
+            # tools/fuzz.py and decomp.me.
+            "pch": not should_diff and path.endswith(".c"),
         }
+        self.options.update(options)
 
 build_objects = [
-    BuildObject('main_content/00_basic_assembly_and_isa.c', True),
-    BuildObject('main_content/01_abi_basics.c', True),
+    BuildObject('main_content/00_basic_assembly_and_isa.c', True, profile=True),
+    BuildObject('main_content/01_abi_basics.c', True, profile=True),
     BuildObject('runtime/runtime_core.c', False),
     BuildObject('runtime/runtime_exception.c', False),
+    BuildObject('runtime/runtime_mem.c', False),
+    BuildObject('runtime/runtime_cache.c', False),
+    BuildObject('runtime/runtime_string.c', False),
+    BuildObject('runtime/runtime_fiber.c', False),
+    BuildObject('runtime/runtime_time.c', False),
+    BuildObject('runtime/trace.c', False),
     BuildObject('runtime/main.cpp', False),
     BuildObject('shared/stuff.c', False),
     BuildObject('shared/sample_functions.c', False),
+    BuildObject('shared/fastmath.c', False),
+    BuildObject('shared/blob.c', False),
+]
+
+# Prolog/epilog linked into every REL module
+rel_module_object = BuildObject('runtime/rel_module.c', False)
+
+# Linked into main.elf only when some BuildObject is built as a module, so
+# the resident image doesn't carry a loader with nothing to load
+rel_loader_object = BuildObject('runtime/rel_loader.c', False)
+
+# Only linked into the benchmark DOL
+bench_objects = [
+    BuildObject('shared/bench.c', False),
+    BuildObject('shared/benchmarks.c', False),
+    BuildObject('shared/container_benchmarks.cpp', False),
+]
+
+# Only linked into the profiling DOL
+profile_objects = [
+    BuildObject('shared/profile.c', False),
+]
+
+# Portable sources compiled with the host compiler, per native executable
+native_test_sources = [
+    'runtime/runtime_core.c',
+    'runtime/runtime_exception.c',
+    'runtime/runtime_mem.c',
+    'runtime/runtime_cache.c',
+    'runtime/runtime_string.c',
+    'runtime/runtime_fiber.c',
+    'runtime/runtime_time.c',
+    'runtime/trace.c',
+    'runtime/rel_loader.c',
+    'shared/profile.c',
+    'shared/fastmath.c',
+    'shared/blob.c',
+    'native/test_main.c',
+    'native/test_containers.cpp',
+    'native/test_rel.c',
+]
+
+native_bench_sources = [
+    'runtime/runtime_core.c',
+    'runtime/runtime_string.c',
+    'runtime/runtime_mem.c',
+    'runtime/runtime_fiber.c',
+    'runtime/runtime_time.c',
+    'runtime/trace.c',
+    f'{target_src_dir}/main_content/00_basic_assembly_and_isa.c',
+    f'{target_src_dir}/main_content/01_abi_basics.c',
+    'shared/stuff.c',
+    'shared/bench.c',
+    'shared/benchmarks.c',
+    'shared/container_benchmarks.cpp',
+    'shared/fastmath.c',
+    'native/bench_main.c',
 ]
 
+# decomp.me compiler name mapping
+COMPILER_MAP = {
+    "GC/1.0": "mwcc_233_144",
+    "GC/1.1": "mwcc_233_159",
+    "GC/1.2.5": "mwcc_233_163",
+    "GC/1.2.5e": "mwcc_233_163e",
+    "GC/1.2.5n": "mwcc_233_163n",
+    "GC/1.3": "mwcc_242_53",
+    "GC/1.3.2": "mwcc_242_81",
+    "GC/1.3.2r": "mwcc_242_81r",
+    "GC/2.0": "mwcc_247_92",
+    "GC/2.5": "mwcc_247_105",
+    "GC/2.6": "mwcc_247_107",
+    "GC/2.7": "mwcc_247_108",
+    "GC/3.0a3": "mwcc_41_51213",
+    "GC/3.0a3.2": "mwcc_41_60126",
+    "GC/3.0a3.3": "mwcc_41_60209",
+    "GC/3.0a3.4": "mwcc_42_60308",
+    "GC/3.0a5": "mwcc_42_60422",
+    "GC/3.0a5.2": "mwcc_41_60831",
+    "GC/3.0": "mwcc_41_60831",
+    "Wii/1.0RC1": "mwcc_42_140",
+    "Wii/0x4201_127": "mwcc_42_142",
+    "Wii/1.0a": "mwcc_42_142",
+    "Wii/1.0": "mwcc_43_145",
+    "Wii/1.1": "mwcc_43_151",
+    "Wii/1.3": "mwcc_43_172",
+    "Wii/1.5": "mwcc_43_188",
+    "Wii/1.6": "mwcc_43_202",
+    "Wii/1.7": "mwcc_43_213",
+}
+
+# Keeps the timestamp of unchanged outputs, so the restat on the configure
+# edge lets ninja skip everything that depends on them
+def write_if_changed(path: Union[str, Path], content: str) -> None:
+    if os.path.exists(path):
+        with open(path, "r", encoding="utf-8") as f:
+            if f.read() == content:
+                return
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(content)
+
 def write_objdiff(build_objects: list) -> None:
 
     objdiff_config: Dict[str, Any] = {
@@ -126,38 +344,6 @@ def write_objdiff(build_objects: list) -> None:
         "progress_categories": [],
     }
 
-    # decomp.me compiler name mapping
-    COMPILER_MAP = {
-        "GC/1.0": "mwcc_233_144",
-        "GC/1.1": "mwcc_233_159",
-        "GC/1.2.5": "mwcc_233_163",
-        "GC/1.2.5e": "mwcc_233_163e",
-        "GC/1.2.5n": "mwcc_233_163n",
-        "GC/1.3": "mwcc_242_53",
-        "GC/1.3.2": "mwcc_242_81",
-        "GC/1.3.2r": "mwcc_242_81r",
-        "GC/2.0": "mwcc_247_92",
-        "GC/2.5": "mwcc_247_105",
-        "GC/2.6": "mwcc_247_107",
-        "GC/2.7": "mwcc_247_108",
-        "GC/3.0a3": "mwcc_41_51213",
-        "GC/3.0a3.2": "mwcc_41_60126",
-        "GC/3.0a3.3": "mwcc_41_60209",
-        "GC/3.0a3.4": "mwcc_42_60308",
-        "GC/3.0a5": "mwcc_42_60422",
-        "GC/3.0a5.2": "mwcc_41_60831",
-        "GC/3.0": "mwcc_41_60831",
-        "Wii/1.0RC1": "mwcc_42_140",
-        "Wii/0x4201_127": "mwcc_42_142",
-        "Wii/1.0a": "mwcc_42_142",
-        "Wii/1.0": "mwcc_43_145",
-        "Wii/1.1": "mwcc_43_151",
-        "Wii/1.3": "mwcc_43_172",
-        "Wii/1.5": "mwcc_43_188",
-        "Wii/1.6": "mwcc_43_202",
-        "Wii/1.7": "mwcc_43_213",
-    }
-
     for build_object in build_objects:
         if build_object.should_diff:
             compiler_version = COMPILER_MAP.get(build_object.options["mw_version"])
@@ -185,18 +371,19 @@ def write_objdiff(build_objects: list) -> None:
                 objdiff_config["units"].append(unit_config)
 
     # Write objdiff.json
-    with open("objdiff.json", "w", encoding="utf-8") as w:
-
-        def unix_path(input: Any) -> str:
-            return str(input).replace(os.sep, "/") if input else ""
+    def unix_path(input: Any) -> str:
+        return str(input).replace(os.sep, "/") if input else ""
 
-        json.dump(objdiff_config, w, indent=4, default=unix_path)
+    write_if_changed("objdiff.json", json.dumps(objdiff_config, indent=4, default=unix_path))
 
 
 out_buf = io.StringIO()
 n = Writer(out_buf)
 
-n.variable("ninja_required_version", "1.3")
+n.variable("ninja_required_version", "1.7")
+n.newline()
+
+n.variable("python", f'"{sys.executable}"')
 n.newline()
 
 n.variable("build_dir", build_dir)
@@ -206,6 +393,11 @@ n.variable("target_build_dir", target_build_dir)
 n.variable("target_out_dir", target_out_dir)
 n.variable("base_build_dir", base_build_dir)
 n.variable("base_out_dir", base_out_dir)
+n.variable("bench_build_dir", bench_build_dir)
+n.variable("bench_out_dir", bench_out_dir)
+n.variable("profile_build_dir", profile_build_dir)
+n.variable("profile_out_dir", profile_out_dir)
+n.variable("native_build_dir", native_build_dir)
 n.newline()
 
 n.variable("mw_version", Path(linker_version))
@@ -338,7 +530,7 @@ mwcc_cmd = f"{wrapper_cmd}{mwcc} $cflags -MMD -c $in -o $basedir"
 mwcc_implicit: List[Optional[Path]] = [compilers_implicit or mwcc, wrapper_implicit]
 
 mwld = compiler_path / "mwldeppc.exe"
-mwld_cmd = f"{wrapper_cmd}{mwld} $ldflags -o $out @$out.rsp"
+mwld_cmd = f"{wrapper_cmd}{mwld} $ldflags -o $out -map $mapfile @$out.rsp"
 mwld_implicit: List[Optional[Path]] = [compilers_implicit or mwld, wrapper_implicit]
 
 n.newline()
@@ -358,19 +550,127 @@ n.rule(
     rspfile_content="$in_newline",
 )
 
-n.comment("Generate DOL")
 n.rule(
-    name="elf2dol",
-    command=f"{dtk} elf2dol $in $out",
-    description="DOL $out",
+    "mwcc_pch",
+    command=f"{wrapper_cmd}{mwcc} $cflags -precompile $out $in",
+    description="PCH $out",
+)
+
+# Built from src/native/elf2dol.c with the host compiler, see below
+native_elf2dol = os.path.join("$native_build_dir", f"elf2dol{EXE}")
+
+if USE_NATIVE_ELF2DOL:
+    n.comment("Generate DOL and its section manifest")
+    n.rule(
+        name="elf2dol",
+        command=f"{native_elf2dol} $in $out --manifest $out.json",
+        description="DOL $out",
+    )
+else:
+    n.comment("Generate DOL")
+    n.rule(
+        name="elf2dol",
+        command=f"{dtk} elf2dol $in $out",
+        description="DOL $out",
+    )
+
+n.comment("Generate RELs from main.elf and the partially linked modules")
+n.rule(
+    name="makerel",
+    command=f"{dtk} rel make -w $in",
+    description="REL $out",
 )
 n.newline()
 
+# Headers the precompiled header can pull in, it has no depfile
+pch_headers = sorted(glob.glob(os.path.join("src", "runtime", "*.h")) + glob.glob(os.path.join("src", "shared", "*.h")))
+pch_outputs: Dict[Tuple[str, str], str] = {}
+
+def write_pch(mwcc_flags: list, mw_version: str) -> str:
+    flags = " ".join(mwcc_flags)
+    key = (mw_version, flags)
+    if key not in pch_outputs:
+        flags_hash = hashlib.sha1(flags.encode()).hexdigest()[:8]
+        out_file = os.path.join("$build_dir", "pch", mw_version, flags_hash, "precompiled.mch")
+        n.build(
+            outputs=out_file,
+            rule="mwcc_pch",
+            inputs=os.path.join("src", PCH_SOURCE),
+            variables={
+                "cflags": flags,
+                "mw_version": mw_version,
+            },
+            implicit=mwcc_implicit + pch_headers,
+        )
+        pch_outputs[key] = out_file
+    return pch_outputs[key]
+
+object_cache = tools_dir / "object_cache.py"
+n.rule(
+    name="cache_fetch",
+    command=f"$python {object_cache} $in $out",
+    description="CACHED $out",
+)
+# The cache entry isn't an output, so `ninja -t clean` leaves a shared
+# OBJECT_CACHE alone; the stamp records that the copy was made
+n.rule(
+    name="cache_store",
+    command=f"$python {object_cache} $in $cached --stamp $out",
+    description="CACHE $in",
+)
+
+header_digests: Dict[Tuple[str, ...], str] = {}
+# Sources and headers the cache keys were computed from, configure.py re-runs
+# when they change so a key never names a stale object
+object_cache_inputs: Set[str] = set()
+object_cache_outputs: Dict[str, str] = {}
+# Cached objects build.ninja copies from. They are listed in the configure
+# edge's depfile, where a missing file re-runs configure.py (which then
+# compiles the object) instead of failing the build.
+object_cache_hits: List[str] = []
+
+def object_cache_path(in_file: str, mwcc_flags: list, options: Dict[str, Any]) -> str:
+    source = os.path.join("src", in_file)
+    object_cache_inputs.add(source)
+
+    dirs = tuple(include_dirs(mwcc_flags))
+    if dirs not in header_digests:
+        header_digests[dirs] = hash_headers(mwcc_flags, object_cache_inputs)
+    with open(source, "rb") as f:
+        key = object_key(
+            options["mw_version"],
+            mwcc_flags,
+            header_digests[dirs],
+            in_file,
+            f.read(),
+            extra=(compilers_tag, str(USE_PCH and options["pch"])),
+        )
+    return object_path(str(OBJECT_CACHE), key)
+
 # TODO: this signature is pretty bad
-def write_build_object(out_files: list, in_file: str, input_build_dir: str, mwcc_flags: list, options: Dict[str, Any]):
+def write_build_object(out_files: list, in_file: str, input_build_dir: str, mwcc_flags: list, options: Dict[str, Any], cache: bool = False):
     out_file = os.path.join(f"${input_build_dir}", os.path.splitext(in_file)[0] + ".o")
     out_files.append(out_file)
 
+    if cache:
+        cached = object_cache_path(in_file, mwcc_flags, options)
+        if os.path.exists(cached):
+            object_cache_hits.append(cached)
+            n.build(
+                outputs=out_file,
+                rule="cache_fetch",
+                inputs=cached,
+                implicit=object_cache,
+            )
+            return
+        object_cache_outputs[cached] = out_file
+
+    implicit = list(mwcc_implicit)
+    if USE_PCH and options["pch"]:
+        pch = write_pch(mwcc_flags, options["mw_version"])
+        mwcc_flags = mwcc_flags + [f"-prefix {pch}"]
+        implicit.append(pch)
+
     n.build(
         outputs=out_file,
         rule="mwcc",
@@ -380,37 +680,456 @@ def write_build_object(out_files: list, in_file: str, input_build_dir: str, mwcc
             "basedir": os.path.join(f"${input_build_dir}", os.path.dirname(in_file)),
             "mw_version": options["mw_version"]
         },
-        implicit=mwcc_implicit,
+        implicit=implicit,
     )
 
-def write_link(out_files: list, input_out_dir: str):
+main_lcf = build_dir / "main.lcf"
+
+def write_lcf() -> None:
+    with open(build_dir / "ldscript.lcf") as f:
+        lcf = f.read()
+    lcf = re.sub(r"(_stack_addr = \(_stack_end \+ )0x[0-9a-fA-F]+", rf"\g<1>{STACK_SIZE:#x}", lcf)
+    lcf = re.sub(r"(_db_stack_addr = \(_stack_addr \+ )0x[0-9a-fA-F]+", rf"\g<1>{DB_STACK_SIZE:#x}", lcf)
+    write_if_changed(main_lcf, lcf)
+
+rel_exports = tools_dir / "rel_exports.py"
+n.rule(
+    name="rel_exports",
+    command=f"$python {rel_exports} $lcf $in -o $out",
+    description="LCF $out",
+)
+
+# With module objects, main.elf is linked with a copy of main.lcf that keeps
+# everything the modules import
+def write_link(out_files: list, input_out_dir: str, module_objects: List[str] = []):
+    lcf = os.path.join("$build_dir", "main.lcf")
+    if module_objects:
+        lcf = os.path.join(f"${input_out_dir}", "main_modules.lcf")
+        n.build(
+            outputs=lcf,
+            rule="rel_exports",
+            inputs=module_objects,
+            variables={"lcf": main_lcf},
+            implicit=[main_lcf, rel_exports, tools_dir / "elffile.py"],
+        )
+
     n.build(
         outputs=os.path.join(f"${input_out_dir}", "main.elf"),
         rule="mwld",
         inputs=out_files,
-        variables={"ldflags": " ".join(RELEASE_MWLD_FLAGS)},
-        implicit=mwld_implicit,
+        variables={
+            "ldflags": " ".join(RELEASE_MWLD_FLAGS + [f"-lcf {lcf}"]),
+            "mapfile": os.path.join(f"${input_out_dir}", "main.elf.MAP"),
+        },
+        implicit=mwld_implicit + [lcf],
+        implicit_outputs=os.path.join(f"${input_out_dir}", "main.elf.MAP"),
     )
     
     n.build(
         outputs=os.path.join(f"${input_out_dir}", "main.dol"),
         rule="elf2dol",
         inputs=os.path.join(f"${input_out_dir}", "main.elf"),
+        implicit=native_elf2dol if USE_NATIVE_ELF2DOL else dtk,
+        implicit_outputs=os.path.join(f"${input_out_dir}", "main.dol.json") if USE_NATIVE_ELF2DOL else None,
+    )
+
+def write_modules(module_files: Dict[str, List[str]], input_out_dir: str) -> List[str]:
+    plfs = []
+    for module, out_files in module_files.items():
+        plf = os.path.join(f"${input_out_dir}", module + ".plf")
+        n.build(
+            outputs=plf,
+            rule="mwld",
+            inputs=out_files,
+            variables={
+                "ldflags": " ".join(MODULE_MWLD_FLAGS),
+                "mapfile": plf + ".MAP",
+            },
+            implicit=mwld_implicit,
+            implicit_outputs=plf + ".MAP",
+        )
+        plfs.append(plf)
+
+    if not plfs:
+        return []
+
+    # Module IDs follow the order the PLFs are passed in
+    rels = [os.path.splitext(plf)[0] + ".rel" for plf in plfs]
+    n.build(
+        outputs=rels,
+        rule="makerel",
+        inputs=[os.path.join(f"${input_out_dir}", "main.elf")] + plfs,
         implicit=dtk,
     )
+    return rels
 
 target_out_files = []
 base_out_files = []
+target_module_files: Dict[str, List[str]] = {}
+base_module_files: Dict[str, List[str]] = {}
 
 for build_object in build_objects:
-    write_build_object(target_out_files, build_object.target_path, "target_build_dir", TARGET_MWCC_FLAGS, build_object.options)
-    write_build_object(base_out_files, build_object.base_path, "base_build_dir", BASE_MWCC_FLAGS, build_object.options)
+    module = build_object.options["module"]
+    if module is None:
+        target_files, base_files = target_out_files, base_out_files
+    else:
+        if module not in target_module_files:
+            target_module_files[module] = []
+            base_module_files[module] = []
+        target_files, base_files = target_module_files[module], base_module_files[module]
+    write_build_object(target_files, build_object.target_path, "target_build_dir", TARGET_MWCC_FLAGS, build_object.options, cache=True)
+    write_build_object(base_files, build_object.base_path, "base_build_dir", BASE_MWCC_FLAGS, build_object.options)
+
+if target_module_files:
+    for main_files, module_files, input_build_dir, flags, cache in (
+        (target_out_files, target_module_files, "target_build_dir", TARGET_MWCC_FLAGS, True),
+        (base_out_files, base_module_files, "base_build_dir", BASE_MWCC_FLAGS, False),
+    ):
+        write_build_object(main_files, rel_loader_object.target_path, input_build_dir, flags, rel_loader_object.options, cache=cache)
+        rel_module_out: List[str] = []
+        write_build_object(rel_module_out, rel_module_object.target_path, input_build_dir, flags, rel_module_object.options, cache=cache)
+        for out_files in module_files.values():
+            out_files.extend(rel_module_out)
 
-write_link(target_out_files, "target_out_dir")
-write_link(base_out_files, "base_out_dir")
+# rel_module.o is in every module's list, pass it once
+write_link(target_out_files, "target_out_dir", sorted(set(sum(target_module_files.values(), []))))
+write_link(base_out_files, "base_out_dir", sorted(set(sum(base_module_files.values(), []))))
+rel_files = write_modules(target_module_files, "target_out_dir")
+rel_files += write_modules(base_module_files, "base_out_dir")
+n.newline()
+
+n.default([
+    os.path.join("$target_out_dir", "main.dol"),
+    os.path.join("$base_out_dir", "main.dol"),
+] + rel_files)
+n.newline()
 
-write_objdiff(build_objects)
+n.comment("Copy the target objects that were compiled into OBJECT_CACHE")
+cache_stamps = []
+for cached, out_file in object_cache_outputs.items():
+    stamp = os.path.join("$build_dir", "object_cache_stamps", os.path.basename(cached) + ".stamp")
+    n.build(
+        outputs=stamp,
+        rule="cache_store",
+        inputs=out_file,
+        implicit=object_cache,
+        variables={"cached": cached},
+    )
+    cache_stamps.append(stamp)
+n.build(
+    outputs="object_cache",
+    rule="phony",
+    inputs=cache_stamps,
+)
+n.newline()
+
+###
+# Benchmark DOL
+###
+n.comment("Benchmark DOL, read results back with tools/bench_results.py")
+bench_out_files = []
+# Modules are linked statically here, the benchmarks don't load RELs
+for build_object in build_objects + bench_objects:
+    write_build_object(bench_out_files, build_object.target_path, "bench_build_dir", BENCH_MWCC_FLAGS, build_object.options)
+write_link(bench_out_files, "bench_out_dir")
+n.build(
+    outputs="bench",
+    rule="phony",
+    inputs=os.path.join("$bench_out_dir", "main.dol"),
+)
+n.newline()
+
+###
+# Profiling DOL
+###
+n.comment("Profiling DOL, read results back with tools/profile_report.py")
+profile_out_files = []
+for build_object in build_objects + profile_objects:
+    flags = PROFILE_MWCC_FLAGS
+    if build_object.options["profile"]:
+        flags = flags + PROFILE_HOOK_FLAGS
+    write_build_object(profile_out_files, build_object.target_path, "profile_build_dir", flags, build_object.options)
+write_link(profile_out_files, "profile_out_dir")
+n.build(
+    outputs="profile",
+    rule="phony",
+    inputs=os.path.join("$profile_out_dir", "main.dol"),
+)
+n.newline()
+
+###
+# Native build
+###
+n.comment("Host compiler build of the portable runtime code with test and benchmark drivers")
+n.rule(
+    name="native_cc",
+    command=f"{NATIVE_CC} $cflags -MMD -MF $out.d -c $in -o $out",
+    description="CC $out",
+    depfile="$out.d",
+    deps="gcc",
+)
+n.rule(
+    name="native_link",
+    command=f"{NATIVE_CC} $in -o $out -lm",
+    description="LINK $out",
+)
+n.rule(
+    name="native_run",
+    command="$in",
+    description="RUN $in",
+)
+
+# Test data for src/shared/blob.c, packed in host layout
+blob_pack = tools_dir / "blob_pack.py"
+native_test_blob = os.path.join("$native_build_dir", "test_blob.c")
+native_test_blob_header = os.path.join("$native_build_dir", "test_blob.h")
+n.rule(
+    name="blob_pack",
+    command=f"$python {blob_pack} $in -o $out --c $name --types $types $args",
+    description="BLOB $out",
+)
+n.build(
+    outputs=native_test_blob,
+    rule="blob_pack",
+    inputs=os.path.join("src", "native", "test_blob.json"),
+    implicit=blob_pack,
+    implicit_outputs=native_test_blob_header,
+    variables={"name": "testBlob", "types": native_test_blob_header, "args": "--native"},
+)
+
+native_objects: Dict[str, str] = {}
+
+# Sources are relative to src/, or generated ones in $native_build_dir
+def write_native_exe(name: str, sources: List[str], generated_headers: List[str] = []) -> str:
+    objs = []
+    for source in sources:
+        generated = source.startswith("$native_build_dir")
+        obj = os.path.splitext(source if generated else os.path.join("$native_build_dir", source))[0] + ".o"
+        if source not in native_objects:
+            n.build(
+                outputs=obj,
+                rule="native_cc",
+                inputs=source if generated else os.path.join("src", source),
+                order_only=generated_headers,
+                variables={
+                    "cflags": " ".join(
+                        NATIVE_CFLAGS
+                        + ["-I$native_build_dir"]
+                        + (NATIVE_CXXFLAGS if source.endswith(".cpp") else [])
+                    )
+                },
+            )
+            native_objects[source] = obj
+        objs.append(obj)
+
+    exe = os.path.join("$native_build_dir", name + EXE)
+    n.build(outputs=exe, rule="native_link", inputs=objs)
+    return exe
+
+native_test = write_native_exe("test", native_test_sources + [native_test_blob], [native_test_blob_header])
+native_bench = write_native_exe("bench", native_bench_sources)
+write_native_exe("elf2dol", ["native/elf2dol.c"])  # Path is native_elf2dol
+n.build(outputs="native", rule="phony", inputs=[native_test, native_bench])
+n.build(outputs="native_test", rule="native_run", inputs=native_test)
+n.build(outputs="native_bench", rule="native_run", inputs=native_bench)
+n.newline()
+
+###
+# Link map sizes
+###
+n.comment("Report section/symbol sizes from the link maps and check budgets")
+linkmap = tools_dir / "linkmap.py"
+link_maps = [
+    os.path.join("$target_out_dir", "main.elf.MAP"),
+    os.path.join("$base_out_dir", "main.elf.MAP"),
+]
+sizes_baseline = build_dir / "sizes_baseline.json"
+sizes_budget_args = " ".join(f"--budget {k}={v:#x}" for k, v in SIZE_BUDGETS.items())
+n.rule(
+    name="sizes",
+    command=f"$python {linkmap} $in --lcf {main_lcf} --baseline {sizes_baseline} $args",
+    description="SIZES",
+)
+n.build(
+    outputs="sizes",
+    rule="sizes",
+    inputs=link_maps,
+    implicit=[linkmap, main_lcf],
+    variables={"args": sizes_budget_args},
+)
+n.build(
+    outputs="sizes_baseline",
+    rule="sizes",
+    inputs=link_maps,
+    implicit=[linkmap, main_lcf],
+    variables={"args": "--write-baseline"},
+)
+n.newline()
+
+###
+# Build statistics
+###
+n.comment("Summarize the last build from .ninja_log")
+buildstats = tools_dir / "buildstats.py"
+buildstats_history = build_dir / "buildstats.jsonl"
+n.rule(
+    name="buildstats",
+    command=f"$python {buildstats} build.ninja .ninja_log --history {buildstats_history} --ignore $out",
+    description="BUILDSTATS",
+)
+n.build(
+    outputs="buildstats",
+    rule="buildstats",
+    implicit=buildstats,
+)
+
+###
+# Stack depth
+###
+n.comment("Measure the worst-case stack depth, re-run configure.py to apply it")
+stack_depth = tools_dir / "stack_depth.py"
+n.rule(
+    name="stack_depth",
+    command=f"$python {stack_depth} $in --write {stack_size_json}",
+    description="STACK",
+)
+n.build(
+    outputs="stack",
+    rule="stack_depth",
+    inputs=[
+        os.path.join("$target_out_dir", "main.elf"),
+        os.path.join("$base_out_dir", "main.elf"),
+    ],
+    implicit=stack_depth,
+)
+n.newline()
+
+###
+# Disassembly listings
+###
+n.comment("objdump listings of every target/base object and side-by-side listings per unit")
+asm_dir = build_dir / "asm"
+objdump = binutils / f"powerpc-eabi-objdump{EXE}"
+asm_listing = tools_dir / "asm_listing.py"
+n.rule(
+    name="objdump",
+    command=f"{CHAIN}{objdump} -drz -M 750cl $in > $out",
+    description="OBJDUMP $out",
+)
+n.rule(
+    name="asm_listing",
+    command=f"$python {asm_listing} $in -o $out --unit $unit",
+    description="ASM $out",
+)
+
+def write_objdump(obj: str, listing: Path) -> Path:
+    n.build(
+        outputs=listing,
+        rule="objdump",
+        inputs=obj,
+        implicit=binutils_implicit,
+    )
+    return listing
+
+asm_listings = []
+for build_object in build_objects:
+    target_asm = write_objdump(
+        os.path.join("$target_build_dir", build_object.target_obj),
+        asm_dir / "target" / (os.path.splitext(build_object.target_path)[0] + ".s"),
+    )
+    base_asm = write_objdump(
+        os.path.join("$base_build_dir", build_object.base_obj),
+        asm_dir / "base" / (os.path.splitext(build_object.base_path)[0] + ".s"),
+    )
+    listing = asm_dir / (build_object.name + ".txt")
+    n.build(
+        outputs=listing,
+        rule="asm_listing",
+        inputs=[target_asm, base_asm],
+        implicit=asm_listing,
+        variables={"unit": build_object.file_path},
+    )
+    asm_listings.append(listing)
+n.build(
+    outputs="asm",
+    rule="phony",
+    inputs=asm_listings,
+)
+n.newline()
+
+###
+# Function fingerprints
+###
+n.comment("Index every target/base function for tools/fingerprint.py lookups")
+fingerprint = tools_dir / "fingerprint.py"
+fingerprint_index = build_dir / "fingerprint.idx"
+n.rule(
+    name="fingerprint",
+    command=f"$python {fingerprint} --index $out update $in",
+    description="FINGERPRINT $out",
+)
+n.build(
+    outputs=fingerprint_index,
+    rule="fingerprint",
+    inputs=[
+        os.path.join(f"${build_dir_var}", obj)
+        for build_object in build_objects
+        for build_dir_var, obj in (
+            ("target_build_dir", build_object.target_obj),
+            ("base_build_dir", build_object.base_obj),
+        )
+    ],
+    implicit=[fingerprint, tools_dir / "elffile.py"],
+)
+n.build(
+    outputs="fingerprint",
+    rule="phony",
+    inputs=fingerprint_index,
+)
+n.newline()
+
+###
+# Regenerate build.ninja
+###
+n.comment("Re-run configure.py when it or anything it reads changes")
+# Directories are inputs too, adding a header changes the PCH dependencies
+configure_inputs = [
+    Path("configure.py"),
+    tools_dir / "ninja_syntax.py",
+    build_dir / "ldscript.lcf",
+    Path("src", "runtime"),
+    Path("src", "shared"),
+]
+if stack_size_json.exists():
+    configure_inputs.append(stack_size_json)
+configure_inputs += sorted(object_cache_inputs)
+
+# Keep the settings configure.py was run with, quoted for the shell (or for
+# CreateProcess on Windows, where ninja runs commands directly)
+def quote_arg(arg: str) -> str:
+    return subprocess.list2cmdline([arg]) if is_windows() else shlex.quote(arg)
+
+configure_args = "".join(f" {escape(quote_arg(f'{k}={v}'))}" for k, v in settings.items() if v)
+configure_depfile = build_dir / "configure.d"
+n.rule(
+    name="configure",
+    command=f"$python configure.py{configure_args}",
+    depfile=configure_depfile,
+    description="CONFIGURE",
+    generator=True,
+    restat=True,
+)
+n.build(
+    outputs="build.ninja",
+    rule="configure",
+    implicit=configure_inputs,
+    implicit_outputs=["objdiff.json", main_lcf],
+)
 
-with open("build.ninja", "w") as out_file:
-    out_file.write(out_buf.getvalue())
+# Tools import this module for its configuration, only write files when run
+if __name__ == "__main__":
+    write_objdiff(build_objects)
+    write_lcf()
+    write_if_changed(configure_depfile, "build.ninja: " + " ".join(p.replace(" ", "\\ ") for p in object_cache_hits) + "\n")
+    write_if_changed("build.ninja", out_buf.getvalue())
 n.close()
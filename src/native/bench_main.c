@@ -0,0 +1,32 @@
+// Runs the cases from src/shared/benchmarks.c natively, `ninja native_bench`
+
+#include <stdio.h>
+
+#include <runtime_mem.h>
+
+#include "bench.h"
+#include "benchmarks.h"
+
+int main( void )
+{
+    u32 i;
+    const BenchResult *res;
+    static u8 arena[ 0x10000 ];
+
+    // __init_mem does this on the target, the fiber case allocates from it
+    mem_init_arena( arena, arena + sizeof( arena ) );
+    run_benchmarks( );
+
+    printf( "Timing overhead: %u ns (subtracted)\n", __bench_results.overhead );
+    if( __bench_results.dropped )
+    {
+        printf( "Warning: %u cases dropped, raise BENCH_MAX_CASES\n", __bench_results.dropped );
+    }
+    printf( "%-24s%6s%10s%10s%10s\n", "case", "reps", "min ns", "median ns", "max ns" );
+    for( i = 0; i < __bench_results.count; ++i )
+    {
+        res = &__bench_results.results[ i ];
+        printf( "%-24s%6u%10u%10u%10u\n", res->name, res->reps, res->min, res->median, res->max );
+    }
+    return 0;
+}
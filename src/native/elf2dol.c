@@ -0,0 +1,497 @@
+// Converts main.elf to a DOL and writes a JSON manifest of where every
+// section went, used by the elf2dol ninja rule
+//
+//     elf2dol main.elf main.dol [--manifest main.dol.json]
+//
+// Allocated sections with contents go into the 7 text and 11 data slots,
+// NOBITS sections into the single bss range. Sections of the same kind are
+// merged into one slot when the gap between them is under DOL_MERGE_GAP and
+// holds no other section; the gap is written as zeros. Slots start 32-byte
+// aligned in the file and are padded to a multiple of 32 bytes when that
+// doesn't run into another section, which the disc loader's DMA wants.
+
+#include <Common.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOL_TEXT_SLOTS 7
+#define DOL_DATA_SLOTS 11
+#define DOL_HEADER_SIZE 0x100
+#define DOL_ALIGN 32
+#define DOL_MERGE_GAP 32
+
+#define MAX_SECTIONS 64
+
+#define SHT_PROGBITS 1
+#define SHT_NOBITS 8
+#define SHF_ALLOC 2
+#define SHF_EXECINSTR 4
+
+enum
+{
+    KIND_TEXT,
+    KIND_DATA,
+    KIND_BSS
+};
+
+static const char *kindNames[] = { "text", "data", "bss" };
+
+typedef struct Section
+{
+    char name[ 32 ];
+    u32 kind;
+    u32 addr;
+    u32 size;
+    u32 offset; // In the ELF
+} Section;
+
+typedef struct Slot
+{
+    u32 kind;
+    u32 addr;
+    u32 size;       // Including gaps and tail padding
+    u32 gapPadding; // Zeros between merged sections
+    u32 tailPadding;
+    u32 fileOffset;
+    u32 first; // Index into the sorted sections
+    u32 count;
+} Slot;
+
+static Section sections[ MAX_SECTIONS ];
+static u32 numSections;
+static Slot slots[ DOL_TEXT_SLOTS + DOL_DATA_SLOTS ];
+static u32 numSlots;
+static u32 entryPoint;
+static u32 bssAddr;
+static u32 bssSize;
+
+/* ================================ *
+ *     ELF reading
+ * ================================ */
+
+static u32 be16( const u8 *p )
+{
+    return ( p[ 0 ] << 8 ) | p[ 1 ];
+}
+
+static u32 be32( const u8 *p )
+{
+    return ( (u32)p[ 0 ] << 24 ) | ( p[ 1 ] << 16 ) | ( p[ 2 ] << 8 ) | p[ 3 ];
+}
+
+static void put32( u8 *p, u32 v )
+{
+    p[ 0 ] = (u8)( v >> 24 );
+    p[ 1 ] = (u8)( v >> 16 );
+    p[ 2 ] = (u8)( v >> 8 );
+    p[ 3 ] = (u8)v;
+}
+
+static int read_at( FILE *f, long offset, void *buf, size_t n )
+{
+    return fseek( f, offset, SEEK_SET ) == 0 && fread( buf, 1, n, f ) == n;
+}
+
+// Only the section headers and names are read here, contents are streamed
+// into the DOL later
+static int read_sections( FILE *f, const char *path )
+{
+    u8 ehdr[ 52 ];
+    u8 shdr[ 40 ];
+    u8 *names;
+    u32 shoff, shentsize, shnum, shstrndx;
+    u32 namesOffset, namesSize;
+    u32 i;
+
+    if( !read_at( f, 0, ehdr, sizeof( ehdr ) ) || memcmp( ehdr, "\x7F" "ELF", 4 ) != 0 )
+    {
+        fprintf( stderr, "%s: not an ELF file\n", path );
+        return 0;
+    }
+    if( ehdr[ 4 ] != 1 || ehdr[ 5 ] != 2 || be16( ehdr + 18 ) != 20 )
+    {
+        fprintf( stderr, "%s: not a 32-bit big-endian PowerPC ELF\n", path );
+        return 0;
+    }
+
+    entryPoint = be32( ehdr + 24 );
+    shoff = be32( ehdr + 32 );
+    shentsize = be16( ehdr + 46 );
+    shnum = be16( ehdr + 48 );
+    shstrndx = be16( ehdr + 50 );
+    if( shentsize < sizeof( shdr ) || shstrndx >= shnum ||
+        !read_at( f, shoff + shstrndx * shentsize, shdr, sizeof( shdr ) ) )
+    {
+        fprintf( stderr, "%s: bad section header table\n", path );
+        return 0;
+    }
+
+    namesOffset = be32( shdr + 16 );
+    namesSize = be32( shdr + 20 );
+    names = (u8 *)malloc( namesSize + 1 );
+    if( names == NULL || !read_at( f, namesOffset, names, namesSize ) )
+    {
+        fprintf( stderr, "%s: can't read section names\n", path );
+        free( names );
+        return 0;
+    }
+    names[ namesSize ] = 0;
+
+    for( i = 0; i < shnum; ++i )
+    {
+        Section *s;
+        u32 type, flags, name;
+
+        if( !read_at( f, shoff + i * shentsize, shdr, sizeof( shdr ) ) )
+        {
+            fprintf( stderr, "%s: truncated section header %u\n", path, i );
+            free( names );
+            return 0;
+        }
+        name = be32( shdr );
+        type = be32( shdr + 4 );
+        flags = be32( shdr + 8 );
+        if( !( flags & SHF_ALLOC ) || be32( shdr + 20 ) == 0 || ( type != SHT_PROGBITS && type != SHT_NOBITS ) )
+        {
+            continue;
+        }
+        if( numSections == MAX_SECTIONS )
+        {
+            fprintf( stderr, "%s: more than %d allocated sections\n", path, MAX_SECTIONS );
+            free( names );
+            return 0;
+        }
+
+        s = &sections[ numSections++ ];
+        snprintf( s->name, sizeof( s->name ), "%s", name < namesSize ? (const char *)names + name : "?" );
+        s->kind = type == SHT_NOBITS ? KIND_BSS : ( flags & SHF_EXECINSTR ) ? KIND_TEXT : KIND_DATA;
+        s->addr = be32( shdr + 12 );
+        s->offset = be32( shdr + 16 );
+        s->size = be32( shdr + 20 );
+    }
+    free( names );
+    return 1;
+}
+
+/* ================================ *
+ *     Layout
+ * ================================ */
+
+static int compare_sections( const void *a, const void *b )
+{
+    const Section *sa = (const Section *)a;
+    const Section *sb = (const Section *)b;
+
+    return sa->addr < sb->addr ? -1 : sa->addr > sb->addr;
+}
+
+// Lowest section start at or after `addr` (bss included), or 0xFFFFFFFF
+static u32 next_section_start( u32 addr )
+{
+    u32 next = 0xFFFFFFFF;
+    u32 i;
+
+    for( i = 0; i < numSections; ++i )
+    {
+        if( sections[ i ].addr >= addr && sections[ i ].addr < next )
+        {
+            next = sections[ i ].addr;
+        }
+    }
+    return next;
+}
+
+static int layout_slots( const char *path )
+{
+    u32 counts[ 2 ] = { 0, 0 };
+    u32 limits[ 2 ] = { DOL_TEXT_SLOTS, DOL_DATA_SLOTS };
+    u32 fileOffset = DOL_HEADER_SIZE;
+    u32 bssEnd = 0;
+    u32 i, k;
+
+    qsort( sections, numSections, sizeof( Section ), compare_sections );
+
+    for( i = 0; i < numSections; ++i )
+    {
+        const Section *s = &sections[ i ];
+        Slot *last = numSlots ? &slots[ numSlots - 1 ] : NULL;
+
+        if( s->kind == KIND_BSS )
+        {
+            if( bssSize == 0 || s->addr < bssAddr )
+            {
+                bssAddr = s->addr;
+            }
+            if( s->addr + s->size > bssEnd )
+            {
+                bssEnd = s->addr + s->size;
+            }
+            bssSize = bssEnd - bssAddr;
+            continue;
+        }
+
+        // Sorted by address, so nothing else starts between the previous
+        // section of this slot and this one when they are neighbours
+        if( last && last->kind == s->kind && last->first + last->count == i && s->addr >= last->addr + last->size &&
+            s->addr - ( last->addr + last->size ) < DOL_MERGE_GAP )
+        {
+            last->gapPadding += s->addr - ( last->addr + last->size );
+            last->size = s->addr + s->size - last->addr;
+            last->count++;
+            continue;
+        }
+
+        if( counts[ s->kind ] == limits[ s->kind ] )
+        {
+            fprintf( stderr, "%s: more than %u %s slots needed at %s\n", path, limits[ s->kind ], kindNames[ s->kind ],
+                     s->name );
+            return 0;
+        }
+        counts[ s->kind ]++;
+        last = &slots[ numSlots++ ];
+        memset( last, 0, sizeof( Slot ) );
+        last->kind = s->kind;
+        last->addr = s->addr;
+        last->size = s->size;
+        last->first = i;
+        last->count = 1;
+    }
+
+    // The file holds the slots in address order, the header lists text and
+    // data slots separately
+    for( k = 0; k < numSlots; ++k )
+    {
+        Slot *slot = &slots[ k ];
+        u32 end = slot->addr + slot->size;
+        u32 padded = ( end + DOL_ALIGN - 1 ) & ~( DOL_ALIGN - 1 );
+
+        if( next_section_start( end ) >= padded )
+        {
+            slot->tailPadding = padded - end;
+            slot->size += slot->tailPadding;
+        }
+        slot->fileOffset = fileOffset;
+        fileOffset = ( fileOffset + slot->size + DOL_ALIGN - 1 ) & ~( DOL_ALIGN - 1 );
+    }
+    return 1;
+}
+
+/* ================================ *
+ *     Output
+ * ================================ */
+
+static int copy_section( FILE *in, FILE *out, const Section *s )
+{
+    u8 buf[ 0x4000 ];
+    u32 done = 0;
+
+    if( fseek( in, s->offset, SEEK_SET ) != 0 )
+    {
+        return 0;
+    }
+    while( done < s->size )
+    {
+        size_t n = s->size - done < sizeof( buf ) ? s->size - done : sizeof( buf );
+        if( fread( buf, 1, n, in ) != n || fwrite( buf, 1, n, out ) != n )
+        {
+            return 0;
+        }
+        done += (u32)n;
+    }
+    return 1;
+}
+
+static int write_zeros( FILE *out, u32 n )
+{
+    static const u8 zeros[ 256 ];
+
+    while( n )
+    {
+        u32 chunk = n < sizeof( zeros ) ? n : sizeof( zeros );
+        if( fwrite( zeros, 1, chunk, out ) != chunk )
+        {
+            return 0;
+        }
+        n -= chunk;
+    }
+    return 1;
+}
+
+static int write_dol( FILE *in, const char *path )
+{
+    u8 header[ DOL_HEADER_SIZE ];
+    u32 counts[ 2 ] = { 0, 0 };
+    u32 pos = DOL_HEADER_SIZE;
+    u32 k, i;
+    FILE *out = fopen( path, "wb" );
+
+    if( out == NULL )
+    {
+        perror( path );
+        return 0;
+    }
+
+    memset( header, 0, sizeof( header ) );
+    for( k = 0; k < numSlots; ++k )
+    {
+        const Slot *slot = &slots[ k ];
+        u32 index = slot->kind == KIND_TEXT ? counts[ 0 ]++ : DOL_TEXT_SLOTS + counts[ 1 ]++;
+        put32( header + 0x00 + 4 * index, slot->fileOffset );
+        put32( header + 0x48 + 4 * index, slot->addr );
+        put32( header + 0x90 + 4 * index, slot->size );
+    }
+    put32( header + 0xD8, bssAddr );
+    put32( header + 0xDC, bssSize );
+    put32( header + 0xE0, entryPoint );
+    if( fwrite( header, 1, sizeof( header ), out ) != sizeof( header ) )
+    {
+        goto fail;
+    }
+
+    for( k = 0; k < numSlots; ++k )
+    {
+        const Slot *slot = &slots[ k ];
+        u32 addr = slot->addr;
+
+        if( !write_zeros( out, slot->fileOffset - pos ) )
+        {
+            goto fail;
+        }
+        for( i = slot->first; i < slot->first + slot->count; ++i )
+        {
+            if( !write_zeros( out, sections[ i ].addr - addr ) || !copy_section( in, out, &sections[ i ] ) )
+            {
+                goto fail;
+            }
+            addr = sections[ i ].addr + sections[ i ].size;
+        }
+        if( !write_zeros( out, slot->tailPadding ) )
+        {
+            goto fail;
+        }
+        pos = slot->fileOffset + slot->size;
+    }
+
+    if( fclose( out ) != 0 )
+    {
+        perror( path );
+        return 0;
+    }
+    return 1;
+
+fail:
+    fprintf( stderr, "%s: write failed\n", path );
+    fclose( out );
+    return 0;
+}
+
+// Section names come from our own link, only quotes and backslashes could
+// need escaping
+static void print_json_string( FILE *out, const char *s )
+{
+    fputc( '"', out );
+    for( ; *s; ++s )
+    {
+        if( *s == '"' || *s == '\\' )
+        {
+            fputc( '\\', out );
+        }
+        fputc( *s, out );
+    }
+    fputc( '"', out );
+}
+
+static int write_manifest( const char *path, const char *dolPath )
+{
+    u32 counts[ 2 ] = { 0, 0 };
+    u32 k, i;
+    u32 fileSize = DOL_HEADER_SIZE;
+    FILE *out = fopen( path, "w" );
+
+    if( out == NULL )
+    {
+        perror( path );
+        return 0;
+    }
+
+    if( numSlots )
+    {
+        fileSize = slots[ numSlots - 1 ].fileOffset + slots[ numSlots - 1 ].size;
+    }
+
+    fprintf( out, "{\n  \"dol\": " );
+    print_json_string( out, dolPath );
+    fprintf( out, ",\n  \"file_size\": %u,\n  \"entry\": %u,\n", fileSize, entryPoint );
+    fprintf( out, "  \"bss\": {\"address\": %u, \"size\": %u},\n", bssAddr, bssSize );
+    fprintf( out, "  \"slots\": [" );
+    for( k = 0; k < numSlots; ++k )
+    {
+        const Slot *slot = &slots[ k ];
+        u32 index = slot->kind == KIND_TEXT ? counts[ 0 ]++ : counts[ 1 ]++;
+
+        fprintf( out, "%s\n    {\"kind\": \"%s\", \"index\": %u, \"address\": %u, \"size\": %u, ", k ? "," : "",
+                 kindNames[ slot->kind ], index, slot->addr, slot->size );
+        fprintf( out, "\"file_offset\": %u, \"gap_padding\": %u, \"tail_padding\": %u, \"sections\": [",
+                 slot->fileOffset, slot->gapPadding, slot->tailPadding );
+        for( i = slot->first; i < slot->first + slot->count; ++i )
+        {
+            fprintf( out, "%s{\"name\": ", i > slot->first ? ", " : "" );
+            print_json_string( out, sections[ i ].name );
+            fprintf( out, ", \"address\": %u, \"size\": %u}", sections[ i ].addr, sections[ i ].size );
+        }
+        fprintf( out, "]}" );
+    }
+    fprintf( out, "\n  ],\n  \"bss_sections\": [" );
+    for( i = 0, k = 0; i < numSections; ++i )
+    {
+        if( sections[ i ].kind != KIND_BSS )
+        {
+            continue;
+        }
+        fprintf( out, "%s\n    {\"name\": ", k++ ? "," : "" );
+        print_json_string( out, sections[ i ].name );
+        fprintf( out, ", \"address\": %u, \"size\": %u}", sections[ i ].addr, sections[ i ].size );
+    }
+    fprintf( out, "\n  ]\n}\n" );
+
+    if( fclose( out ) != 0 )
+    {
+        perror( path );
+        return 0;
+    }
+    return 1;
+}
+
+int main( int argc, char **argv )
+{
+    const char *manifest = NULL;
+    FILE *in;
+    int ok;
+
+    if( argc == 5 && strcmp( argv[ 3 ], "--manifest" ) == 0 )
+    {
+        manifest = argv[ 4 ];
+    }
+    else if( argc != 3 )
+    {
+        fprintf( stderr, "usage: %s main.elf main.dol [--manifest main.dol.json]\n", argv[ 0 ] );
+        return 2;
+    }
+
+    in = fopen( argv[ 1 ], "rb" );
+    if( in == NULL )
+    {
+        perror( argv[ 1 ] );
+        return 1;
+    }
+    ok = read_sections( in, argv[ 1 ] ) && layout_slots( argv[ 1 ] ) && write_dol( in, argv[ 2 ] ) &&
+         ( manifest == NULL || write_manifest( manifest, argv[ 2 ] ) );
+    fclose( in );
+    if( !ok )
+    {
+        remove( argv[ 2 ] );
+    }
+    return ok ? 0 : 1;
+}
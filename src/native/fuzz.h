@@ -0,0 +1,52 @@
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <Common.h>
+
+/* ================================ *
+ *     Differential fuzzer
+ * ================================ */
+
+// Each argument and global is a slot of raw bytes. Scalars use the first
+// element of the data area; pointer arguments get the whole data area as an
+// array, with guard bytes on both sides so stray writes are compared too.
+
+#define FUZZ_MAX_ARGS 16
+#define FUZZ_MAX_GLOBALS 16
+#define FUZZ_GUARD 16
+#define FUZZ_DATA 64
+#define FUZZ_SLOT_SIZE ( FUZZ_GUARD + FUZZ_DATA + FUZZ_GUARD )
+
+// Element kinds, integers are described by size and signedness
+#define FUZZ_SIGNED 0x10
+#define FUZZ_FLOAT 0x20
+
+#define FUZZ_KIND( T ) ( (u8)( sizeof( T ) | ( (T)-1 < 0 ? FUZZ_SIGNED : 0 ) ) )
+#define FUZZ_KIND_FLOAT( T ) ( (u8)( sizeof( T ) | FUZZ_FLOAT ) )
+
+typedef struct FuzzSlot
+{
+    const char *name;
+    u8 kind;
+    u8 pointer;
+} FuzzSlot;
+
+// a[ i ] points at the value (or array) for argument i, ret at the return value
+typedef void ( *FuzzThunk )( void *fn, void **a, void *ret );
+
+typedef struct FuzzCase
+{
+    const char *name;
+    FuzzThunk thunk;
+    u8 retKind; // 0 for void
+    u8 numArgs;
+    FuzzSlot args[ FUZZ_MAX_ARGS ];
+} FuzzCase;
+
+// Generated per unit by tools/fuzz.py
+extern const FuzzCase fuzzCases[];
+extern const u32 fuzzNumCases;
+extern const FuzzSlot fuzzGlobals[];
+extern const u32 fuzzNumGlobals;
+
+#endif
@@ -0,0 +1,788 @@
+// Differential fuzzer driver, built and run per unit by tools/fuzz.py
+//
+// Usage: fuzz <answers.so> <template.so> [--seed n] [--start n] [--count n] [--case name]
+//
+// Both sides define the same symbols, so each is loaded as its own shared
+// object with RTLD_LOCAL and looked up separately. Every case is called on
+// both with the same generated arguments and globals for iterations
+// [start, start + count); the first input whose return value, pointer
+// contents, globals or trap differ is minimized and printed as a JSON line.
+// Inputs depend only on the seed and iteration, so ranges can be split
+// across processes and the earliest divergence is the same either way.
+
+#include <dlfcn.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "fuzz.h"
+
+#define FUZZ_MAX_SLOTS ( FUZZ_MAX_ARGS + FUZZ_MAX_GLOBALS )
+#define FUZZ_MINIMIZE_PASSES 64
+#define FUZZ_MAX_CANDIDATES 72
+
+// Seconds without a finished call before it counts as hung
+#define FUZZ_TIMEOUT 2
+
+#define KIND_SIZE( k ) ( ( k ) & 0xF )
+
+typedef struct FuzzInput
+{
+    u8 slots[ FUZZ_MAX_SLOTS ][ FUZZ_SLOT_SIZE ];
+} FuzzInput;
+
+typedef struct FuzzOutcome
+{
+    int trap; // Signal number, 0 if the call returned
+    u8 ret[ 8 ];
+    FuzzInput state;
+} FuzzOutcome;
+
+typedef struct FuzzSide
+{
+    const char *path;
+    void *handle;
+    void *globals[ FUZZ_MAX_GLOBALS ];
+} FuzzSide;
+
+static FuzzSide sides[ 2 ];
+static const char *sideNames[ 2 ] = { "answers", "template" };
+
+static sigjmp_buf fuzzJump;
+static volatile sig_atomic_t fuzzInCall;
+static volatile u32 fuzzCalls;
+static u32 fuzzWatchdogCalls;
+static u8 fuzzAltStack[ 0x10000 ];
+
+/* ================================ *
+ *     Traps
+ * ================================ */
+
+static void fuzz_signal( int sig )
+{
+    if( !fuzzInCall )
+    {
+        if( sig != SIGALRM )
+        {
+            signal( sig, SIG_DFL );
+            raise( sig );
+        }
+        return;
+    }
+
+    // SIGALRM is a watchdog tick, only a call that hasn't moved on since
+    // the last tick is a timeout
+    if( sig == SIGALRM && fuzzCalls != fuzzWatchdogCalls )
+    {
+        fuzzWatchdogCalls = fuzzCalls;
+        return;
+    }
+
+    fuzzInCall = 0;
+    siglongjmp( fuzzJump, sig );
+}
+
+static void fuzz_install_traps( void )
+{
+    static const int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGALRM };
+    struct sigaction sa;
+    struct itimerval timer;
+    stack_t ss;
+    u32 i;
+
+    // Stack overflows need somewhere to run the handler
+    ss.ss_sp = fuzzAltStack;
+    ss.ss_size = sizeof( fuzzAltStack );
+    ss.ss_flags = 0;
+    sigaltstack( &ss, NULL );
+
+    // SA_NODEFER so jumping out of the handler needs no mask restore, which
+    // lets every call use the cheap sigsetjmp( env, 0 )
+    memset( &sa, 0, sizeof( sa ) );
+    sa.sa_handler = fuzz_signal;
+    sa.sa_flags = SA_NODEFER | SA_ONSTACK;
+    sigemptyset( &sa.sa_mask );
+    for( i = 0; i < sizeof( signals ) / sizeof( signals[ 0 ] ); ++i )
+    {
+        sigaction( signals[ i ], &sa, NULL );
+    }
+
+    timer.it_interval.tv_sec = FUZZ_TIMEOUT;
+    timer.it_interval.tv_usec = 0;
+    timer.it_value = timer.it_interval;
+    setitimer( ITIMER_REAL, &timer, NULL );
+}
+
+/* ================================ *
+ *     Input generation
+ * ================================ */
+
+static u64 splitmix64( u64 *state )
+{
+    u64 z = ( *state += 0x9E3779B97F4A7C15ull );
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    return z ^ ( z >> 31 );
+}
+
+static void store_int( u8 *p, u8 kind, s64 v )
+{
+    u8 b = (u8)v;
+    u16 h = (u16)v;
+    u32 w = (u32)v;
+
+    switch( KIND_SIZE( kind ) )
+    {
+    case 1:
+        memcpy( p, &b, 1 );
+        break;
+    case 2:
+        memcpy( p, &h, 2 );
+        break;
+    case 4:
+        memcpy( p, &w, 4 );
+        break;
+    default:
+        memcpy( p, &v, 8 );
+        break;
+    }
+}
+
+static s64 load_int( const u8 *p, u8 kind )
+{
+    s8 sb;
+    u8 b;
+    s16 sh;
+    u16 h;
+    s32 sw;
+    u32 w;
+    s64 v;
+
+    switch( KIND_SIZE( kind ) | ( kind & FUZZ_SIGNED ) )
+    {
+    case 1 | FUZZ_SIGNED:
+        memcpy( &sb, p, 1 );
+        return sb;
+    case 1:
+        memcpy( &b, p, 1 );
+        return b;
+    case 2 | FUZZ_SIGNED:
+        memcpy( &sh, p, 2 );
+        return sh;
+    case 2:
+        memcpy( &h, p, 2 );
+        return h;
+    case 4 | FUZZ_SIGNED:
+        memcpy( &sw, p, 4 );
+        return sw;
+    case 4:
+        memcpy( &w, p, 4 );
+        return w;
+    default:
+        memcpy( &v, p, 8 );
+        return v;
+    }
+}
+
+static void store_float( u8 *p, u8 kind, double v )
+{
+    float f = (float)v;
+
+    if( KIND_SIZE( kind ) == 4 )
+    {
+        memcpy( p, &f, 4 );
+    }
+    else
+    {
+        memcpy( p, &v, 8 );
+    }
+}
+
+static double load_float( const u8 *p, u8 kind )
+{
+    float f;
+    double d;
+
+    if( KIND_SIZE( kind ) == 4 )
+    {
+        memcpy( &f, p, 4 );
+        return f;
+    }
+    memcpy( &d, p, 8 );
+    return d;
+}
+
+static void gen_element( u8 *p, u8 kind, u64 *rng )
+{
+    static const s64 specialInts[] = {
+        0, 1, -1, 2, 7, 0x7F, 0x80, 0xFF, 0x7FFF, 0x8000, 0xFFFF,
+        0x7FFFFFFF, -0x7FFFFFFF - 1, 0xFFFFFFFF, 0x7FFFFFFFFFFFFFFF,
+    };
+    static const double specialFloats[] = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 1e-45, 1.17549435e-38, 3.40282347e38, 1e300,
+    };
+    u64 r = splitmix64( rng );
+    u64 bits = splitmix64( rng );
+    double zero = 0.0;
+
+    if( kind & FUZZ_FLOAT )
+    {
+        switch( r & 7 )
+        {
+        case 0:
+            store_float( p, kind, specialFloats[ ( r >> 8 ) % ( sizeof( specialFloats ) / sizeof( double ) ) ] *
+                                      ( ( r >> 32 ) & 1 ? -1.0 : 1.0 ) );
+            break;
+        case 1:
+            // inf and nan
+            store_float( p, kind, ( ( r >> 8 ) & 1 ? 0.0 : 1.0 ) / zero * ( ( r >> 9 ) & 1 ? -1.0 : 1.0 ) );
+            break;
+        case 2:
+        case 3:
+            store_float( p, kind, (double)( (s64)( bits % 65 ) - 32 ) );
+            break;
+        case 4:
+        case 5:
+            store_float( p, kind, ( (double)( bits >> 11 ) / 9007199254740992.0 - 0.5 ) * 2000.0 );
+            break;
+        default:
+            memcpy( p, &bits, KIND_SIZE( kind ) );
+            break;
+        }
+        return;
+    }
+
+    switch( r & 7 )
+    {
+    case 0:
+    case 1:
+        store_int( p, kind, specialInts[ ( r >> 8 ) % ( sizeof( specialInts ) / sizeof( s64 ) ) ] );
+        break;
+    case 2:
+    case 3:
+        store_int( p, kind, (s64)( bits % 33 ) - 16 );
+        break;
+    default:
+        memcpy( p, &bits, KIND_SIZE( kind ) );
+        break;
+    }
+}
+
+static void gen_slot( u8 *slot, u8 kind, u64 *rng )
+{
+    u32 size = KIND_SIZE( kind );
+    u32 i;
+
+    for( i = 0; i < FUZZ_SLOT_SIZE; i += size )
+    {
+        gen_element( slot + i, kind, rng );
+    }
+}
+
+static void gen_input( const FuzzCase *c, u64 seed, u64 iteration, FuzzInput *in )
+{
+    u64 rng = seed ^ ( iteration * 0xD1B54A32D192ED03ull );
+    u32 i;
+
+    // Scalars only need their first element
+    for( i = 0; i < c->numArgs; ++i )
+    {
+        if( c->args[ i ].pointer )
+        {
+            gen_slot( in->slots[ i ], c->args[ i ].kind, &rng );
+        }
+        else
+        {
+            gen_element( in->slots[ i ] + FUZZ_GUARD, c->args[ i ].kind, &rng );
+        }
+    }
+    for( i = 0; i < fuzzNumGlobals; ++i )
+    {
+        gen_element( in->slots[ FUZZ_MAX_ARGS + i ] + FUZZ_GUARD, fuzzGlobals[ i ].kind, &rng );
+    }
+}
+
+/* ================================ *
+ *     Running and comparing
+ * ================================ */
+
+static void run_side( const FuzzSide *side, void *fn, const FuzzCase *c, const FuzzInput *in, FuzzOutcome *out )
+{
+    void *args[ FUZZ_MAX_ARGS ];
+    u32 i;
+    int sig;
+
+    memcpy( &out->state, in, sizeof( *in ) );
+    memset( out->ret, 0, sizeof( out->ret ) );
+    out->trap = 0;
+
+    for( i = 0; i < c->numArgs; ++i )
+    {
+        args[ i ] = out->state.slots[ i ] + FUZZ_GUARD;
+    }
+    for( i = 0; i < fuzzNumGlobals; ++i )
+    {
+        if( side->globals[ i ] )
+        {
+            memcpy( side->globals[ i ], out->state.slots[ FUZZ_MAX_ARGS + i ] + FUZZ_GUARD,
+                    KIND_SIZE( fuzzGlobals[ i ].kind ) );
+        }
+    }
+
+    sig = sigsetjmp( fuzzJump, 0 );
+    if( sig )
+    {
+        out->trap = sig;
+        return;
+    }
+    fuzzInCall = 1;
+    c->thunk( fn, args, out->ret );
+    fuzzInCall = 0;
+    ++fuzzCalls;
+
+    for( i = 0; i < fuzzNumGlobals; ++i )
+    {
+        if( side->globals[ i ] )
+        {
+            memcpy( out->state.slots[ FUZZ_MAX_ARGS + i ] + FUZZ_GUARD, side->globals[ i ],
+                    KIND_SIZE( fuzzGlobals[ i ].kind ) );
+        }
+    }
+}
+
+// Bitwise, except that any two NaNs are equal
+static BOOL elements_equal( const u8 *a, const u8 *b, u8 kind )
+{
+    double x;
+    double y;
+
+    if( kind & FUZZ_FLOAT )
+    {
+        x = load_float( a, kind );
+        y = load_float( b, kind );
+        if( x != x && y != y )
+        {
+            return TRUE;
+        }
+    }
+    return memcmp( a, b, KIND_SIZE( kind ) ) == 0;
+}
+
+static BOOL slots_equal( const u8 *a, const u8 *b, u8 kind )
+{
+    u32 size = KIND_SIZE( kind );
+    u32 i;
+
+    for( i = 0; i < FUZZ_SLOT_SIZE; i += size )
+    {
+        if( !elements_equal( a + i, b + i, kind ) )
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static BOOL outcomes_equal( const FuzzCase *c, const FuzzOutcome *a, const FuzzOutcome *b )
+{
+    u32 i;
+
+    if( a->trap || b->trap )
+    {
+        return a->trap == b->trap;
+    }
+    if( c->retKind && !elements_equal( a->ret, b->ret, c->retKind ) )
+    {
+        return FALSE;
+    }
+    // Scalar arguments are passed by value and can't change
+    for( i = 0; i < c->numArgs; ++i )
+    {
+        if( c->args[ i ].pointer && !slots_equal( a->state.slots[ i ], b->state.slots[ i ], c->args[ i ].kind ) )
+        {
+            return FALSE;
+        }
+    }
+    for( i = 0; i < fuzzNumGlobals; ++i )
+    {
+        if( !elements_equal( a->state.slots[ FUZZ_MAX_ARGS + i ] + FUZZ_GUARD,
+                             b->state.slots[ FUZZ_MAX_ARGS + i ] + FUZZ_GUARD, fuzzGlobals[ i ].kind ) )
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static BOOL diverges( const FuzzCase *c, void **fns, const FuzzInput *in, FuzzOutcome *out )
+{
+    run_side( &sides[ 0 ], fns[ 0 ], c, in, &out[ 0 ] );
+    run_side( &sides[ 1 ], fns[ 1 ], c, in, &out[ 1 ] );
+    return !outcomes_equal( c, &out[ 0 ], &out[ 1 ] );
+}
+
+/* ================================ *
+ *     Minimizing
+ * ================================ */
+
+// Lower is simpler: zero, then small integers, then fractions, then
+// non-finite values
+static double element_cost( const u8 *p, u8 kind )
+{
+    double v;
+    s64 i;
+
+    if( kind & FUZZ_FLOAT )
+    {
+        v = load_float( p, kind );
+        if( v != v || v - v != 0.0 )
+        {
+            return 1e300;
+        }
+        v = v < 0 ? -v * 1.5 : v;
+        return v < 9e18 && v == (double)(s64)v ? v : v + 1e200;
+    }
+
+    i = load_int( p, kind );
+    if( i < 0 && ( kind & FUZZ_SIGNED ) )
+    {
+        return -(double)i * 1.5;
+    }
+    return kind & FUZZ_SIGNED ? (double)i : (double)(u64)i;
+}
+
+// Simpler values to try for an element. Subtracting each power of two
+// below the magnitude walks a threshold down in logarithmic steps.
+static u32 candidates( const u8 *p, u8 kind, u8 out[][ 8 ] )
+{
+    u32 n = 0;
+    double v;
+    double step;
+    s64 i;
+    u64 mag;
+    u32 k;
+
+    if( kind & FUZZ_FLOAT )
+    {
+        v = load_float( p, kind );
+        store_float( out[ n++ ], kind, 0.0 );
+        store_float( out[ n++ ], kind, 1.0 );
+        if( v == v && v - v == 0.0 )
+        {
+            if( v > -9e18 && v < 9e18 )
+            {
+                store_float( out[ n++ ], kind, (double)(s64)v );
+            }
+            store_float( out[ n++ ], kind, -v );
+            store_float( out[ n++ ], kind, v / 2 );
+            for( k = 0, step = 1.0; k < 64 && step < ( v < 0 ? -v : v ); ++k, step *= 2 )
+            {
+                store_float( out[ n++ ], kind, v < 0 ? v + step : v - step );
+            }
+        }
+        return n;
+    }
+
+    i = load_int( p, kind );
+    mag = ( kind & FUZZ_SIGNED ) && i < 0 ? 0 - (u64)i : (u64)i;
+    store_int( out[ n++ ], kind, 0 );
+    store_int( out[ n++ ], kind, 1 );
+    store_int( out[ n++ ], kind, (s64)( 0 - (u64)i ) );
+    store_int( out[ n++ ], kind, kind & FUZZ_SIGNED ? i / 2 : (s64)( (u64)i / 2 ) );
+    for( k = 0; k < 64 && ( 1ull << k ) <= mag; ++k )
+    {
+        store_int( out[ n++ ], kind, (s64)( ( kind & FUZZ_SIGNED ) && i < 0 ? (u64)i + ( 1ull << k ) : (u64)i - ( 1ull << k ) ) );
+    }
+    return n;
+}
+
+// Greedily replaces each element with a simpler value while the
+// divergence persists
+static void minimize( const FuzzCase *c, void **fns, FuzzInput *in, FuzzOutcome *out )
+{
+    u8 cands[ FUZZ_MAX_CANDIDATES ][ 8 ];
+    u8 saved[ 8 ];
+    u32 pass;
+    u32 slot;
+    u32 offset;
+    u32 end;
+    u32 n;
+    u32 k;
+    u8 kind;
+    u8 size;
+    BOOL changed = TRUE;
+
+    for( pass = 0; pass < FUZZ_MINIMIZE_PASSES && changed; ++pass )
+    {
+        changed = FALSE;
+        for( slot = 0; slot < FUZZ_MAX_SLOTS; ++slot )
+        {
+            if( slot < FUZZ_MAX_ARGS ? slot >= c->numArgs : slot - FUZZ_MAX_ARGS >= fuzzNumGlobals )
+            {
+                continue;
+            }
+            kind = slot < FUZZ_MAX_ARGS ? c->args[ slot ].kind : fuzzGlobals[ slot - FUZZ_MAX_ARGS ].kind;
+            size = KIND_SIZE( kind );
+
+            // Only the first element of scalars and globals is used
+            offset = 0;
+            end = FUZZ_SLOT_SIZE;
+            if( slot >= FUZZ_MAX_ARGS || !c->args[ slot ].pointer )
+            {
+                offset = FUZZ_GUARD;
+                end = FUZZ_GUARD + size;
+            }
+
+            for( ; offset < end; offset += size )
+            {
+                n = candidates( in->slots[ slot ] + offset, kind, cands );
+                for( k = 0; k < n; ++k )
+                {
+                    if( element_cost( cands[ k ], kind ) >= element_cost( in->slots[ slot ] + offset, kind ) )
+                    {
+                        continue;
+                    }
+                    memcpy( saved, in->slots[ slot ] + offset, size );
+                    memcpy( in->slots[ slot ] + offset, cands[ k ], size );
+                    if( diverges( c, fns, in, out ) )
+                    {
+                        changed = TRUE;
+                    }
+                    else
+                    {
+                        memcpy( in->slots[ slot ] + offset, saved, size );
+                    }
+                }
+            }
+        }
+    }
+
+    // Leave the outcomes of the final input behind for the report
+    diverges( c, fns, in, out );
+}
+
+/* ================================ *
+ *     Reporting
+ * ================================ */
+
+static void print_element( const u8 *p, u8 kind )
+{
+    double v;
+
+    if( kind & FUZZ_FLOAT )
+    {
+        v = load_float( p, kind );
+        if( v != v )
+        {
+            printf( "\"nan\"" );
+        }
+        else if( v - v != 0.0 )
+        {
+            printf( v < 0 ? "\"-inf\"" : "\"inf\"" );
+        }
+        else
+        {
+            printf( KIND_SIZE( kind ) == 4 ? "%.9g" : "%.17g", v );
+        }
+    }
+    else if( kind & FUZZ_SIGNED )
+    {
+        printf( "%lld", (long long)load_int( p, kind ) );
+    }
+    else
+    {
+        printf( "%llu", (unsigned long long)(u64)load_int( p, kind ) );
+    }
+}
+
+static void print_slot( const char *name, const u8 *slot, u8 kind, BOOL pointer )
+{
+    u32 size = KIND_SIZE( kind );
+    u32 i;
+
+    printf( "\"%s\": ", name );
+    if( !pointer )
+    {
+        print_element( slot + FUZZ_GUARD, kind );
+        return;
+    }
+
+    printf( "[" );
+    for( i = 0; i < FUZZ_DATA; i += size )
+    {
+        printf( i ? ", " : "" );
+        print_element( slot + FUZZ_GUARD + i, kind );
+    }
+    printf( "]" );
+}
+
+// Continues a JSON object, sep is printed before the first member
+static void print_state( const FuzzCase *c, const FuzzInput *state, BOOL pointersOnly, const char *sep )
+{
+    u32 i;
+
+    for( i = 0; i < c->numArgs; ++i )
+    {
+        if( !pointersOnly || c->args[ i ].pointer )
+        {
+            printf( "%s", sep );
+            sep = ", ";
+            print_slot( c->args[ i ].name, state->slots[ i ], c->args[ i ].kind, c->args[ i ].pointer );
+        }
+    }
+    for( i = 0; i < fuzzNumGlobals; ++i )
+    {
+        printf( "%s", sep );
+        sep = ", ";
+        print_slot( fuzzGlobals[ i ].name, state->slots[ FUZZ_MAX_ARGS + i ], fuzzGlobals[ i ].kind, FALSE );
+    }
+}
+
+static void print_outcome( const FuzzCase *c, const FuzzInput *in, const FuzzOutcome *out )
+{
+    u32 i;
+
+    printf( "{\"trap\": %d", out->trap );
+    if( !out->trap )
+    {
+        if( c->retKind )
+        {
+            printf( ", \"return\": " );
+            print_element( out->ret, c->retKind );
+        }
+        print_state( c, &out->state, TRUE, ", " );
+        for( i = 0; i < c->numArgs; ++i )
+        {
+            if( c->args[ i ].pointer &&
+                ( memcmp( in->slots[ i ], out->state.slots[ i ], FUZZ_GUARD ) ||
+                  memcmp( in->slots[ i ] + FUZZ_GUARD + FUZZ_DATA, out->state.slots[ i ] + FUZZ_GUARD + FUZZ_DATA,
+                          FUZZ_GUARD ) ) )
+            {
+                printf( ", \"%s.out_of_bounds\": 1", c->args[ i ].name );
+            }
+        }
+    }
+    printf( "}" );
+}
+
+/* ================================ *
+ *     Driver
+ * ================================ */
+
+static void fuzz_case( const FuzzCase *c, u64 seed, u64 start, u64 count )
+{
+    static FuzzInput in;
+    static FuzzOutcome out[ 2 ];
+    void *fns[ 2 ];
+    u64 it;
+    u32 i;
+
+    for( i = 0; i < 2; ++i )
+    {
+        fns[ i ] = dlsym( sides[ i ].handle, c->name );
+        if( !fns[ i ] )
+        {
+            printf( "{\"function\": \"%s\", \"status\": \"missing\", \"side\": \"%s\"}\n", c->name, sideNames[ i ] );
+            return;
+        }
+    }
+
+    for( it = start; it < start + count; ++it )
+    {
+        gen_input( c, seed, it, &in );
+        if( diverges( c, fns, &in, out ) )
+        {
+            // Every attempt on a hang would cost a watchdog period
+            if( out[ 0 ].trap != SIGALRM && out[ 1 ].trap != SIGALRM )
+            {
+                minimize( c, fns, &in, out );
+            }
+            printf( "{\"function\": \"%s\", \"status\": \"diverged\", \"iteration\": %llu, \"inputs\": {",
+                    c->name, (unsigned long long)it );
+            print_state( c, &in, FALSE, "" );
+            printf( "}, \"answers\": " );
+            print_outcome( c, &in, &out[ 0 ] );
+            printf( ", \"template\": " );
+            print_outcome( c, &in, &out[ 1 ] );
+            printf( "}\n" );
+            return;
+        }
+    }
+
+    printf( "{\"function\": \"%s\", \"status\": \"ok\", \"iterations\": %llu}\n", c->name, (unsigned long long)count );
+}
+
+int main( int argc, char **argv )
+{
+    u64 seed = 0;
+    u64 start = 0;
+    u64 count = 100000;
+    const char *only = NULL;
+    int positional = 0;
+    int i;
+    u32 g;
+
+    for( i = 1; i < argc; ++i )
+    {
+        if( !strcmp( argv[ i ], "--seed" ) && i + 1 < argc )
+        {
+            seed = strtoull( argv[ ++i ], NULL, 0 );
+        }
+        else if( !strcmp( argv[ i ], "--start" ) && i + 1 < argc )
+        {
+            start = strtoull( argv[ ++i ], NULL, 0 );
+        }
+        else if( !strcmp( argv[ i ], "--count" ) && i + 1 < argc )
+        {
+            count = strtoull( argv[ ++i ], NULL, 0 );
+        }
+        else if( !strcmp( argv[ i ], "--case" ) && i + 1 < argc )
+        {
+            only = argv[ ++i ];
+        }
+        else if( positional < 2 )
+        {
+            sides[ positional++ ].path = argv[ i ];
+        }
+        else
+        {
+            fprintf( stderr, "Unexpected argument %s\n", argv[ i ] );
+            return 2;
+        }
+    }
+    if( positional != 2 )
+    {
+        fprintf( stderr, "Usage: %s <answers.so> <template.so> [--seed n] [--start n] [--count n] [--case name]\n",
+                 argv[ 0 ] );
+        return 2;
+    }
+
+    for( i = 0; i < 2; ++i )
+    {
+        sides[ i ].handle = dlopen( sides[ i ].path, RTLD_NOW | RTLD_LOCAL );
+        if( !sides[ i ].handle )
+        {
+            fprintf( stderr, "%s\n", dlerror( ) );
+            return 1;
+        }
+        for( g = 0; g < fuzzNumGlobals; ++g )
+        {
+            sides[ i ].globals[ g ] = dlsym( sides[ i ].handle, fuzzGlobals[ g ].name );
+        }
+    }
+
+    fuzz_install_traps( );
+    setvbuf( stdout, NULL, _IOLBF, 0 );
+
+    for( g = 0; g < fuzzNumCases; ++g )
+    {
+        if( !only || !strcmp( only, fuzzCases[ g ].name ) )
+        {
+            fuzz_case( &fuzzCases[ g ], seed, start, count );
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef NATIVE_TEST_H
+#define NATIVE_TEST_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Native test helpers
+ * ================================ */
+
+extern int testFailures;
+extern int testChecks;
+
+#define CHECK( cond ) \
+    do \
+    { \
+        ++testChecks; \
+        if( !( cond ) ) \
+        { \
+            ++testFailures; \
+            printf( "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond ); \
+        } \
+    } while( 0 )
+
+// test_containers.cpp
+void test_containers( void );
+
+// test_rel.c
+void test_rel_loader( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+// Host-side tests for src/shared/containers.h, called from test_main.c
+
+#include <containers.h>
+
+#include "native_test.h"
+
+// Counts live instances, so leaked or double-destroyed elements show up
+struct Tracked
+{
+    static int live;
+
+    Tracked( ) : value( 0 ) { live++; }
+    Tracked( u32 v ) : value( v ) { live++; }
+    Tracked( const Tracked &other ) : value( other.value ) { live++; }
+    ~Tracked( ) { live--; }
+    Tracked &operator=( const Tracked &other )
+    {
+        value = other.value;
+        return *this;
+    }
+
+    u32 value;
+};
+
+int Tracked::live;
+
+static void test_fixed_vector( void )
+{
+    {
+        FixedVector<Tracked, 8> v;
+        u32 i;
+
+        CHECK( v.empty( ) && v.capacity( ) == 8 );
+        for( i = 0; i < 8; i++ )
+        {
+            CHECK( v.push_back( Tracked( i ) ) == &v[ i ] );
+        }
+        CHECK( v.full( ) && Tracked::live == 8 );
+        CHECK( v.push_back( Tracked( 99 ) ) == NULL );
+        CHECK( v.alloc_back( ) == NULL );
+        CHECK( Tracked::live == 8 );
+
+        // 0 1 2 3 4 5 6 7 -> 0 2 3 4 5 6 7 -> 0 7 3 4 5 6
+        v.erase( 1 );
+        CHECK( v.size( ) == 7 && v[ 1 ].value == 2 && v.back( ).value == 7 );
+        v.erase_unordered( 1 );
+        CHECK( v.size( ) == 6 && v[ 1 ].value == 7 && v.back( ).value == 6 );
+        v.erase_unordered( 5 );
+        CHECK( v.size( ) == 5 && v.back( ).value == 5 );
+        CHECK( Tracked::live == 5 );
+
+        u32 sum = 0;
+        for( Tracked *t = v.begin( ); t != v.end( ); t++ )
+        {
+            sum += t->value;
+        }
+        CHECK( sum == 0 + 7 + 3 + 4 + 5 );
+
+        v.pop_back( );
+        CHECK( v.alloc_back( )->value == 0 && v.size( ) == 5 );
+    }
+    // Destructor clears
+    CHECK( Tracked::live == 0 );
+}
+
+static void test_fixed_hash_map( void )
+{
+    // Random inserts/erases against a direct-mapped reference; the small key
+    // range keeps clusters long and wrapping around the end
+    enum
+    {
+        KEYS = 48
+    };
+    {
+        FixedHashMap<u32, Tracked, 64> map;
+        u32 reference[ KEYS ];
+        BOOL present[ KEYS ] = { 0 };
+        u32 seed = 12345;
+        u32 count = 0;
+        u32 i;
+        u32 step;
+
+        for( step = 0; step < 20000; step++ )
+        {
+            seed = seed * 1664525 + 1013904223;
+            u32 key = ( seed >> 8 ) % KEYS;
+            if( ( seed >> 28 ) < 9 )
+            {
+                Tracked *value = map.insert( key * 64, Tracked( step ) );
+                CHECK( value && value->value == step );
+                count += !present[ key ];
+                present[ key ] = TRUE;
+                reference[ key ] = step;
+            }
+            else
+            {
+                CHECK( map.erase( key * 64 ) == present[ key ] );
+                count -= present[ key ];
+                present[ key ] = FALSE;
+            }
+        }
+
+        CHECK( map.size( ) == count );
+        CHECK( Tracked::live == (int)count );
+        for( i = 0; i < KEYS; i++ )
+        {
+            Tracked *value = map.find( i * 64 );
+            CHECK( present[ i ] ? value && value->value == reference[ i ] : value == NULL );
+        }
+
+        u32 seen = 0;
+        for( u32 s = map.first( ); s != map.end( ); s = map.next( s ) )
+        {
+            CHECK( present[ map.key_at( s ) / 64 ] );
+            seen++;
+        }
+        CHECK( seen == count );
+    }
+    CHECK( Tracked::live == 0 );
+
+    // Completely full, every key still found and further inserts refused
+    {
+        FixedHashMap<const void *, int, 16> map;
+        static char objects[ 17 ];
+        int i;
+
+        for( i = 0; i < 16; i++ )
+        {
+            CHECK( map.insert( &objects[ i ], i ) != NULL );
+        }
+        CHECK( map.insert( &objects[ 16 ], 16 ) == NULL );
+        CHECK( map.find( &objects[ 16 ] ) == NULL );
+        CHECK( *map.insert( &objects[ 3 ], 33 ) == 33 && map.size( ) == 16 );
+        for( i = 0; i < 16; i++ )
+        {
+            CHECK( map.erase( &objects[ i ] ) );
+            if( i + 1 < 16 )
+            {
+                CHECK( *map.find( &objects[ i + 1 ] ) == ( i + 1 == 3 ? 33 : i + 1 ) );
+            }
+        }
+        CHECK( map.empty( ) );
+    }
+}
+
+struct ReadyTag;
+
+struct Task : IntrusiveLink<Task>, IntrusiveLink<ReadyTag>
+{
+    int id;
+};
+
+static void test_intrusive_list( void )
+{
+    Task tasks[ 4 ];
+    IntrusiveList<Task> all;
+    IntrusiveList<Task, ReadyTag> ready;
+    int i;
+
+    CHECK( all.empty( ) && all.front( ) == NULL && all.pop_front( ) == NULL );
+    for( i = 0; i < 4; i++ )
+    {
+        tasks[ i ].id = i;
+        all.push_back( &tasks[ i ] );
+    }
+    ready.push_front( &tasks[ 2 ] );
+    ready.push_front( &tasks[ 0 ] );
+    ready.insert_after( &tasks[ 0 ], &tasks[ 1 ] );
+    ready.insert_before( &tasks[ 0 ], &tasks[ 3 ] );
+    CHECK( all.size( ) == 4 && ready.size( ) == 4 );
+
+    // ready: 3 0 1 2, all: 0 1 2 3
+    int expect[ 4 ] = { 3, 0, 1, 2 };
+    Task *t = ready.front( );
+    for( i = 0; i < 4; i++, t = ready.next( t ) )
+    {
+        CHECK( t && t->id == expect[ i ] );
+    }
+    CHECK( t == NULL );
+    CHECK( all.back( )->id == 3 && all.prev( all.back( ) )->id == 2 );
+
+    // Removing from one list leaves the other alone
+    ready.remove( &tasks[ 0 ] );
+    CHECK( !static_cast<IntrusiveLink<ReadyTag> &>( tasks[ 0 ] ).linked( ) );
+    CHECK( static_cast<IntrusiveLink<Task> &>( tasks[ 0 ] ).linked( ) );
+    CHECK( ready.pop_back( )->id == 2 && ready.pop_front( )->id == 3 );
+    CHECK( ready.size( ) == 1 && all.size( ) == 4 );
+
+    all.clear( );
+    CHECK( all.empty( ) && !static_cast<IntrusiveLink<Task> &>( tasks[ 3 ] ).linked( ) );
+}
+
+static void test_pool( void )
+{
+    Pool<Tracked, 4> pool;
+    Tracked *objects[ 4 ];
+    int i;
+
+    for( i = 0; i < 4; i++ )
+    {
+        objects[ i ] = pool.alloc( Tracked( i ) );
+        CHECK( objects[ i ] && objects[ i ]->value == (u32)i && pool.owns( objects[ i ] ) );
+    }
+    CHECK( pool.full( ) && pool.alloc( ) == NULL && Tracked::live == 4 );
+
+    // Freed slots are reused most recent first
+    pool.free( objects[ 1 ] );
+    pool.free( objects[ 3 ] );
+    CHECK( pool.size( ) == 2 && Tracked::live == 2 );
+    CHECK( pool.alloc( ) == objects[ 3 ] && pool.alloc( Tracked( 7 ) ) == objects[ 1 ] );
+    CHECK( objects[ 1 ]->value == 7 && objects[ 3 ]->value == 0 );
+
+    Tracked outside;
+    CHECK( !pool.owns( &outside ) );
+    for( i = 0; i < 4; i++ )
+    {
+        pool.free( objects[ i ] );
+    }
+    CHECK( pool.size( ) == 0 && Tracked::live == 1 );
+}
+
+void test_containers( void )
+{
+    test_fixed_vector( );
+    test_fixed_hash_map( );
+    test_intrusive_list( );
+    test_pool( );
+}
@@ -0,0 +1,739 @@
+// Host-side tests for the portable runtime code, run with `ninja native_test`
+
+#include <runtime_cache.h>
+#include <runtime_core.h>
+#include <runtime_exception.h>
+#include <runtime_fiber.h>
+#include <runtime_mem.h>
+#include <blob.h>
+#include <fastmath.h>
+#include <profile.h>
+#include <trace.h>
+
+#include <math.h>
+
+#include "native_test.h"
+#include "test_blob.h" // Packed from test_blob.json by configure.py
+
+int testFailures;
+int testChecks;
+
+static void test_memset( void )
+{
+    u8 buf[ 64 ];
+    size_t off;
+    size_t len;
+    size_t i;
+
+    for( off = 0; off < 8; ++off )
+    {
+        for( len = 0; len < 40; ++len )
+        {
+            for( i = 0; i < sizeof( buf ); ++i )
+            {
+                buf[ i ] = 0xAA;
+            }
+
+            CHECK( memset( buf + off, 0x5C, len ) == buf + off );
+            for( i = 0; i < sizeof( buf ); ++i )
+            {
+                CHECK( buf[ i ] == ( i >= off && i < off + len ? 0x5C : 0xAA ) );
+            }
+        }
+    }
+}
+
+static void test_memcpy( void )
+{
+    u8 src[ 64 ];
+    u8 dst[ 64 ];
+    size_t soff;
+    size_t doff;
+    size_t len;
+    size_t i;
+
+    for( i = 0; i < sizeof( src ); ++i )
+    {
+        src[ i ] = (u8)( i * 7 + 1 );
+    }
+
+    for( soff = 0; soff < 4; ++soff )
+    {
+        for( doff = 0; doff < 4; ++doff )
+        {
+            for( len = 0; len < 40; ++len )
+            {
+                for( i = 0; i < sizeof( dst ); ++i )
+                {
+                    dst[ i ] = 0;
+                }
+
+                CHECK( memcpy( dst + doff, src + soff, len ) == dst + doff );
+                for( i = 0; i < sizeof( dst ); ++i )
+                {
+                    if( i >= doff && i < doff + len )
+                    {
+                        CHECK( dst[ i ] == src[ soff + i - doff ] );
+                    }
+                    else
+                    {
+                        CHECK( dst[ i ] == 0 );
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Reference results for the word-at-a-time string functions
+static void naive_memmove( u8 *d, const u8 *s, size_t n )
+{
+    u8 tmp[ 128 ];
+    size_t i;
+
+    for( i = 0; i < n; ++i )
+    {
+        tmp[ i ] = s[ i ];
+    }
+    for( i = 0; i < n; ++i )
+    {
+        d[ i ] = tmp[ i ];
+    }
+}
+
+static int sign( int x )
+{
+    return ( x > 0 ) - ( x < 0 );
+}
+
+static void test_memmove( void )
+{
+    u8 buf[ 128 ];
+    u8 ref[ 128 ];
+    size_t soff;
+    size_t doff;
+    size_t len;
+    size_t i;
+
+    // Every source/destination alignment, overlapping in both directions
+    for( soff = 0; soff < 24; ++soff )
+    {
+        for( doff = 0; doff < 24; ++doff )
+        {
+            for( len = 0; len + 24 <= sizeof( buf ) && len < 80; ++len )
+            {
+                for( i = 0; i < sizeof( buf ); ++i )
+                {
+                    buf[ i ] = ref[ i ] = (u8)( i * 13 + 5 );
+                }
+
+                naive_memmove( ref + doff, ref + soff, len );
+                CHECK( memmove( buf + doff, buf + soff, len ) == buf + doff );
+                for( i = 0; i < sizeof( buf ); ++i )
+                {
+                    CHECK( buf[ i ] == ref[ i ] );
+                }
+            }
+        }
+    }
+}
+
+static void test_memcmp( void )
+{
+    u8 a[ 48 ];
+    u8 b[ 48 ];
+    size_t aoff;
+    size_t boff;
+    size_t len;
+    size_t diff;
+    size_t i;
+
+    for( aoff = 0; aoff < 4; ++aoff )
+    {
+        for( boff = 0; boff < 4; ++boff )
+        {
+            for( len = 0; len < 40; ++len )
+            {
+                for( i = 0; i < len; ++i )
+                {
+                    a[ aoff + i ] = b[ boff + i ] = (u8)( i * 7 );
+                }
+                CHECK( memcmp( a + aoff, b + boff, len ) == 0 );
+
+                // Each position, both orders, with the high bit set so a
+                // signed comparison would get it wrong
+                for( diff = 0; diff < len; ++diff )
+                {
+                    b[ boff + diff ] = (u8)( a[ aoff + diff ] + 0x80 );
+                    CHECK( sign( memcmp( a + aoff, b + boff, len ) ) ==
+                           sign( a[ aoff + diff ] - b[ boff + diff ] ) );
+                    CHECK( sign( memcmp( b + boff, a + aoff, len ) ) ==
+                           -sign( a[ aoff + diff ] - b[ boff + diff ] ) );
+                    b[ boff + diff ] = a[ aoff + diff ];
+                }
+            }
+        }
+    }
+}
+
+static void test_memchr( void )
+{
+    u8 buf[ 48 ];
+    size_t off;
+    size_t len;
+    size_t pos;
+    size_t i;
+
+    for( off = 0; off < 4; ++off )
+    {
+        for( len = 0; len < 40; ++len )
+        {
+            for( i = 0; i < sizeof( buf ); ++i )
+            {
+                buf[ i ] = 0x80;
+            }
+            CHECK( memchr( buf + off, 0x81, len ) == NULL );
+
+            for( pos = 0; pos < len; ++pos )
+            {
+                buf[ off + pos ] = 0x81;
+                // Matches are found through a sign extended int as well
+                CHECK( memchr( buf + off, 0x81, len ) == buf + off + pos );
+                CHECK( memchr( buf + off, (s8)0x81, len ) == buf + off + pos );
+                buf[ off + pos ] = 0x80;
+            }
+
+            // Not past the end
+            buf[ off + len ] = 0x81;
+            CHECK( memchr( buf + off, 0x81, len ) == NULL );
+        }
+    }
+}
+
+static void test_strlen_strcmp( void )
+{
+    char a[ 48 ];
+    char b[ 48 ];
+    size_t aoff;
+    size_t boff;
+    size_t len;
+    size_t diff;
+    size_t i;
+
+    for( aoff = 0; aoff < 4; ++aoff )
+    {
+        for( boff = 0; boff < 4; ++boff )
+        {
+            for( len = 0; len < 40; ++len )
+            {
+                for( i = 0; i < len; ++i )
+                {
+                    a[ aoff + i ] = b[ boff + i ] = (char)( 'a' + i % 26 );
+                }
+                a[ aoff + len ] = b[ boff + len ] = '\0';
+                // Bytes after the terminator must not matter
+                a[ aoff + len + 1 ] = 'x';
+                b[ boff + len + 1 ] = 'y';
+
+                CHECK( strlen( a + aoff ) == len );
+                CHECK( strcmp( a + aoff, b + boff ) == 0 );
+
+                for( diff = 0; diff < len; ++diff )
+                {
+                    b[ boff + diff ] = (char)0xE0;
+                    CHECK( strcmp( a + aoff, b + boff ) < 0 );
+                    CHECK( strcmp( b + boff, a + aoff ) > 0 );
+                    b[ boff + diff ] = a[ aoff + diff ];
+                }
+
+                // A prefix compares lower
+                if( len > 0 )
+                {
+                    b[ boff + len - 1 ] = '\0';
+                    CHECK( strcmp( a + aoff, b + boff ) > 0 );
+                    b[ boff + len - 1 ] = a[ aoff + len - 1 ];
+                }
+            }
+        }
+    }
+}
+
+// Measures the max errors documented in fastmath.h, each check allows a
+// little headroom over the measured value
+static double rel_error( double got, double want )
+{
+    return fabs( got / want - 1.0 );
+}
+
+static void test_fastmath( void )
+{
+    double err[ 10 ] = { 0 };
+    double x;
+    double y;
+    double a;
+    float fx;
+    Vec3 v;
+    Vec3 n;
+    u32 i;
+    u32 j;
+
+    // Every mantissa step near 1..4 repeats across exponents, plus a sweep
+    // over the whole useful range
+    for( i = 0; i < 300000; ++i )
+    {
+        fx = i < 150000 ? 1.0f + 3.0f * i / 150000 : (float)pow( 10.0, -30.0 + 60.0 * ( i - 150000 ) / 150000 );
+        x = fx;
+        err[ 0 ] = fmax( err[ 0 ], rel_error( fast_rsqrt_lo( fx ), 1.0 / sqrt( x ) ) );
+        err[ 1 ] = fmax( err[ 1 ], rel_error( fast_rsqrt_hi( fx ), 1.0 / sqrt( x ) ) );
+        err[ 2 ] = fmax( err[ 2 ], rel_error( fast_recip_lo( fx ), 1.0 / x ) );
+        err[ 3 ] = fmax( err[ 3 ], rel_error( fast_recip_hi( fx ), 1.0 / x ) );
+    }
+
+    // Densely over a few periods, then across the documented |x| < 1e6
+    for( i = 0; i <= 2000000; ++i )
+    {
+        fx = i <= 1000000 ? (float)( -100.0 + 200.0 * i / 1000000 ) : (float)( -999999.0 + 1999998.0 * ( i - 1000001 ) / 999999 );
+        x = fx;
+        err[ 4 ] = fmax( err[ 4 ], fabs( fast_sin_lo( fx ) - sin( x ) ) );
+        err[ 4 ] = fmax( err[ 4 ], fabs( fast_cos_lo( fx ) - cos( x ) ) );
+        err[ 5 ] = fmax( err[ 5 ], fabs( fast_sin_hi( fx ) - sin( x ) ) );
+        err[ 5 ] = fmax( err[ 5 ], fabs( fast_cos_hi( fx ) - cos( x ) ) );
+    }
+
+    // Directions all around the circle at several magnitudes
+    for( i = 0; i < 200000; ++i )
+    {
+        for( j = 0; j < 3; ++j )
+        {
+            a = -3.14159265358979 + 6.28318530717958 * i / 200000;
+            x = (float)( cos( a ) * pow( 100.0, j ) );
+            y = (float)( sin( a ) * pow( 100.0, j ) );
+            err[ 6 ] = fmax( err[ 6 ], fabs( fast_atan2_lo( (float)y, (float)x ) - atan2( y, x ) ) );
+            err[ 7 ] = fmax( err[ 7 ], fabs( fast_atan2_hi( (float)y, (float)x ) - atan2( y, x ) ) );
+        }
+    }
+
+    for( i = 1; i < 100000; ++i )
+    {
+        v.x = (float)( i * 0.37 );
+        v.y = (float)( -1000.0 / i );
+        v.z = (float)( i % 17 ) - 8.0f;
+        x = sqrt( (double)v.x * v.x + (double)v.y * v.y + (double)v.z * v.z );
+        err[ 8 ] = fmax( err[ 8 ], rel_error( vec3_length( &v ), x ) );
+        vec3_normalize( &n, &v );
+        err[ 9 ] = fmax( err[ 9 ], fabs( sqrt( (double)n.x * n.x + (double)n.y * n.y + (double)n.z * n.z ) - 1.0 ) );
+    }
+
+    printf( "fastmath max error: rsqrt %.2g/%.2g, recip %.2g/%.2g, sin/cos %.2g/%.2g, atan2 %.2g/%.2g, "
+            "vec3 length %.2g, normalize %.2g\n",
+            err[ 0 ], err[ 1 ], err[ 2 ], err[ 3 ], err[ 4 ], err[ 5 ], err[ 6 ], err[ 7 ], err[ 8 ], err[ 9 ] );
+
+    CHECK( err[ 0 ] < 1.5e-3 );
+    CHECK( err[ 1 ] < 3e-6 );
+    CHECK( err[ 2 ] < 1.5e-7 );
+    CHECK( err[ 3 ] < 1e-7 );
+    CHECK( err[ 4 ] < 6.2e-3 );
+    CHECK( err[ 5 ] < 2e-5 );
+    CHECK( err[ 6 ] < 3.9e-3 );
+    CHECK( err[ 7 ] < 1.3e-5 );
+    CHECK( err[ 8 ] < 3e-6 );
+    CHECK( err[ 9 ] < 3e-6 );
+
+    // Zero vectors stay zero
+    v.x = v.y = v.z = 0.0f;
+    CHECK( vec3_length( &v ) == 0.0f );
+    CHECK( vec3_normalize( &n, &v ) == 0.0f && n.x == 0.0f && n.y == 0.0f && n.z == 0.0f );
+    CHECK( fast_atan2_hi( 0.0f, 0.0f ) == 0.0f );
+}
+
+static int dtorOrder[ 4 ];
+static int dtorCount;
+
+static void record_dtor( void *obj, s16 method )
+{
+    CHECK( method == -1 );
+    dtorOrder[ dtorCount++ ] = *(int *)obj;
+}
+
+static void test_destructor_chain( void )
+{
+    static int objs[ 3 ] = { 1, 2, 3 };
+    static DtorLink links[ 3 ];
+    int i;
+
+    for( i = 0; i < 3; ++i )
+    {
+        __register_global_object( &objs[ i ], record_dtor, &links[ i ] );
+    }
+    __destroy_global_chain( );
+
+    // Destroyed in reverse order of construction
+    CHECK( dtorCount == 3 );
+    CHECK( dtorOrder[ 0 ] == 3 );
+    CHECK( dtorOrder[ 1 ] == 2 );
+    CHECK( dtorOrder[ 2 ] == 1 );
+
+    // The chain is empty afterwards
+    __destroy_global_chain( );
+    CHECK( dtorCount == 3 );
+}
+
+static void test_fragment_registry( void )
+{
+    static const ExtabIndexInfo eti[ 1 ];
+    int i;
+
+    for( i = 0; i < NUM_FRAGMENT; ++i )
+    {
+        CHECK( __register_fragment( eti, NULL ) == i );
+    }
+    CHECK( __register_fragment( eti, NULL ) == -1 );
+
+    __unregister_fragment( -1 );
+    __unregister_fragment( NUM_FRAGMENT );
+    CHECK( __register_fragment( eti, NULL ) == -1 );
+
+    // Freed slots are reused
+    __unregister_fragment( 3 );
+    CHECK( __register_fragment( eti, NULL ) == 3 );
+
+    for( i = 0; i < NUM_FRAGMENT; ++i )
+    {
+        __unregister_fragment( i );
+    }
+}
+
+static void test_stack_high_water( void )
+{
+    static u32 stack[ 256 ];
+    u32 *hi = stack + 256;
+    u32 *sp = hi - 16;
+    u32 *guard = (u32 *)( (u8 *)sp - MEM_STACK_GUARD );
+    int i;
+
+    mem_init_stack( stack, hi, sp );
+    CHECK( __mem_stats.magic == MEM_STATS_MAGIC );
+    CHECK( __mem_stats.stackSize == sizeof( stack ) );
+    for( i = 0; stack + i < guard; ++i )
+    {
+        CHECK( stack[ i ] == MEM_STACK_PAINT );
+    }
+
+    // Untouched paint reports only the unpainted top
+    CHECK( mem_stack_high_water( ) == (u32)( (u8 *)hi - (u8 *)guard ) );
+
+    stack[ 100 ] = 0;
+    CHECK( mem_stack_high_water( ) == 156 * sizeof( u32 ) );
+    stack[ 200 ] = 0;
+    CHECK( mem_stack_high_water( ) == 156 * sizeof( u32 ) );
+    stack[ 0 ] = 0;
+    CHECK( mem_stack_high_water( ) == sizeof( stack ) );
+    CHECK( __mem_stats.stackHighWater == sizeof( stack ) );
+}
+
+static void test_arena( void )
+{
+    static u8 arena[ 256 ];
+    u8 *p;
+    u8 *q;
+    void *mark;
+
+    mem_init_arena( arena, arena + sizeof( arena ) );
+    CHECK( __mem_stats.arenaSize == sizeof( arena ) );
+    CHECK( __mem_stats.arenaUsed == 0 );
+
+    p = (u8 *)arena_alloc( 3, 1 );
+    CHECK( p == arena );
+    q = (u8 *)arena_alloc( 8, 32 );
+    CHECK( ( (uintptr_t)q & 31 ) == 0 && q > p );
+    CHECK( __mem_stats.arenaUsed == (u32)( q + 8 - arena ) );
+
+    mark = arena_mark( );
+    CHECK( arena_alloc( 200, 4 ) != NULL );
+    CHECK( arena_alloc( 200, 4 ) == NULL );
+    CHECK( __mem_stats.arenaPeak == (u32)( (u8 *)mark + 200 - arena ) );
+
+    // Releasing keeps the peak
+    arena_release( mark );
+    CHECK( arena_mark( ) == mark );
+    CHECK( __mem_stats.arenaUsed == (u32)( (u8 *)mark - arena ) );
+    CHECK( __mem_stats.arenaPeak == (u32)( (u8 *)mark + 200 - arena ) );
+
+    // Marks outside the live range are ignored
+    arena_release( arena + sizeof( arena ) );
+    CHECK( arena_mark( ) == mark );
+
+    arena_release( arena );
+    CHECK( arena_alloc( sizeof( arena ), 1 ) == arena );
+    CHECK( arena_alloc( 0, 1 ) == arena + sizeof( arena ) );
+    CHECK( arena_alloc( 1, 1 ) == NULL );
+}
+
+static void test_cache_ranges( void )
+{
+    static u8 buf[ 4 * CACHE_BLOCK_SIZE ] __attribute__( ( aligned( CACHE_BLOCK_SIZE ) ) );
+    CacheRange ranges[ 2 ];
+    u32 off;
+    u32 len;
+    u32 i;
+    u32 first;
+    u32 last;
+
+    for( off = 0; off < 2 * CACHE_BLOCK_SIZE; ++off )
+    {
+        CHECK( CacheBlockCount( buf + off, 0 ) == 0 );
+        CHECK( CACHE_BLOCK_START( buf + off ) == (uintptr_t)buf + off / CACHE_BLOCK_SIZE * CACHE_BLOCK_SIZE );
+
+        for( len = 1; off + len <= sizeof( buf ); ++len )
+        {
+            first = off / CACHE_BLOCK_SIZE;
+            last = ( off + len - 1 ) / CACHE_BLOCK_SIZE;
+            CHECK( CacheBlockCount( buf + off, len ) == last - first + 1 );
+
+            // dcbz clears the whole blocks the range touches
+            for( i = 0; i < sizeof( buf ); ++i )
+            {
+                buf[ i ] = 0xAA;
+            }
+            DCZeroRange( buf + off, len );
+            for( i = 0; i < sizeof( buf ); ++i )
+            {
+                u32 block = i / CACHE_BLOCK_SIZE;
+                CHECK( buf[ i ] == ( block >= first && block <= last ? 0 : 0xAA ) );
+            }
+        }
+    }
+
+    // The other operations have no visible effect on the host
+    ranges[ 0 ].addr = buf + 3;
+    ranges[ 0 ].nBytes = 40;
+    ranges[ 1 ].addr = buf;
+    ranges[ 1 ].nBytes = 0;
+    DCFlushRange( buf + 1, 63 );
+    DCStoreRange( buf + 1, 63 );
+    ICInvalidateRange( buf + 1, 63 );
+    ICSyncRange( buf, 0 );
+    ICSyncRangeList( ranges, 2 );
+    ICSyncRangeList( ranges, 0 );
+}
+
+static void test_trace_ring( void )
+{
+    u32 i;
+    u32 slot;
+
+    trace_reset( );
+    CHECK( __trace_buffer.magic == TRACE_MAGIC );
+    CHECK( __trace_buffer.capacity == TRACE_CAPACITY );
+
+    TRACE_BEGIN( 7 );
+    TRACE_END( 7 );
+    CHECK( __trace_buffer.head == 2 );
+    CHECK( __trace_buffer.events[ 0 ].id == 7 );
+    CHECK( !( __trace_buffer.events[ 0 ].delta & TRACE_END_FLAG ) );
+    CHECK( __trace_buffer.events[ 1 ].delta & TRACE_END_FLAG );
+
+    // Wraps around, overwriting the oldest events
+    for( i = 0; i < TRACE_CAPACITY + 3; ++i )
+    {
+        TRACE_BEGIN( 100 + i );
+    }
+    CHECK( __trace_buffer.head == TRACE_CAPACITY + 5 );
+    for( i = 0; i < TRACE_CAPACITY; ++i )
+    {
+        slot = ( __trace_buffer.head - TRACE_CAPACITY + i ) & ( TRACE_CAPACITY - 1 );
+        CHECK( __trace_buffer.events[ slot ].id == 100 + 3 + i );
+    }
+}
+
+static ProfileEntry *find_profile_entry( u32 key )
+{
+    int i;
+
+    for( i = 0; i < PROFILE_MAX_FUNCS; ++i )
+    {
+        if( __profile_table.entries[ i ].key == key )
+        {
+            return &__profile_table.entries[ i ];
+        }
+    }
+    return NULL;
+}
+
+static void test_profile( void )
+{
+    static char names[ PROFILE_MAX_FUNCS + 1 ];
+    ProfileEntry *outer;
+    ProfileEntry *inner;
+    volatile u32 spin;
+    int i;
+
+    CHECK( __profile_table.magic == PROFILE_MAGIC );
+    CHECK( __profile_table.capacity == PROFILE_MAX_FUNCS );
+
+    __PROFILE_ENTRY( &names[ 0 ] );
+    for( i = 0; i < 2; ++i )
+    {
+        __PROFILE_ENTRY( &names[ 1 ] );
+        for( spin = 0; spin < 100000; ++spin )
+        {
+        }
+        __PROFILE_EXIT( &names[ 1 ] );
+    }
+    __PROFILE_EXIT( &names[ 0 ] );
+
+    outer = find_profile_entry( (u32)(uintptr_t)&names[ 0 ] );
+    inner = find_profile_entry( (u32)(uintptr_t)&names[ 1 ] );
+    CHECK( outer && inner );
+    CHECK( outer->calls == 1 && inner->calls == 2 );
+    CHECK( inner->inclusive > 0 && inner->inclusive == inner->exclusive );
+    // The callee's time is part of the caller's inclusive time only
+    CHECK( outer->inclusive >= inner->inclusive );
+    CHECK( outer->exclusive == outer->inclusive - inner->inclusive );
+
+    // Functions beyond the table's capacity are dropped, but stay balanced
+    for( i = 0; i < PROFILE_MAX_FUNCS + 1; ++i )
+    {
+        __PROFILE_ENTRY( &names[ i ] );
+        __PROFILE_EXIT( &names[ i ] );
+    }
+    CHECK( __profile_table.dropped == 1 );
+    CHECK( find_profile_entry( (u32)(uintptr_t)&names[ 1 ] )->calls == 3 );
+}
+
+static char fiberLog[ 16 ];
+static u32 fiberLogLen;
+static BOOL fiberJoinResult;
+
+static void fiber_log_twice( void *arg )
+{
+    fiberLog[ fiberLogLen++ ] = *(const char *)arg;
+    fiber_yield( );
+    fiberLog[ fiberLogLen++ ] = *(const char *)arg - 'a' + 'A';
+}
+
+static void fiber_join_main( void *arg )
+{
+    fiberJoinResult = fiber_join( (Fiber *)arg );
+}
+
+static void test_fibers( void )
+{
+    static u8 arena[ 0x20000 ];
+    Fiber *self;
+    Fiber *a;
+    Fiber *b;
+    Fiber *c;
+    void *mark;
+
+    mem_init_arena( arena, arena + sizeof( arena ) );
+    self = fiber_current( );
+    CHECK( self->state == FIBER_RUNNING );
+
+    // Nothing else to run, both return immediately
+    fiber_yield( );
+    CHECK( !fiber_join( self ) );
+
+    mark = arena_mark( );
+    a = fiber_create( fiber_log_twice, "a", 0x4000 );
+    b = fiber_create( fiber_log_twice, "b", 0x4000 );
+    CHECK( a && b && fiber_ready_count( ) == 2 );
+    CHECK( ( (uintptr_t)a->stack & ( FIBER_STACK_ALIGN - 1 ) ) == 0 );
+
+    // a runs until its yield, then b, then a finishes and wakes us behind b
+    CHECK( fiber_join( a ) );
+    CHECK( a->state == FIBER_DONE && b->state == FIBER_DONE );
+    CHECK( fiber_join( b ) );
+    CHECK( fiberLogLen == 4 && memcmp( fiberLog, "abAB", 4 ) == 0 );
+    CHECK( a->switches == 2 && fiber_ready_count( ) == 0 );
+
+    // c joining us while we wait on c would deadlock, so its join fails
+    c = fiber_create( fiber_join_main, self, 0 );
+    CHECK( c->stackSize == FIBER_MIN_STACK );
+    fiberJoinResult = TRUE;
+    CHECK( fiber_join( c ) );
+    CHECK( !fiberJoinResult );
+
+    // Out of arena leaves it as it was
+    arena_release( mark );
+    CHECK( fiber_create( fiber_log_twice, "x", sizeof( arena ) ) == NULL );
+    CHECK( arena_mark( ) == mark );
+    CHECK( self->state == FIBER_RUNNING && fiber_current( ) == self );
+}
+
+static void test_blob( void )
+{
+    static u64 arena[ 0x100 ];
+    static u64 moved[ 0x100 ];
+    static u32 foreign[ 16 ];
+    BlobTable *table;
+    BlobTable *copy;
+    BlobItem *items;
+    u32 size = blob_size( testBlob );
+
+    CHECK( size != 0 && size <= sizeof( moved ) );
+    table = (BlobTable *)blob_load( testBlob );
+    CHECK( table != NULL );
+    if( table == NULL )
+    {
+        return;
+    }
+
+    items = table->items;
+    CHECK( table->count == 3 && table->none == NULL );
+    CHECK( table->values[ 0 ] == -1 && table->values[ 2 ] == 2147483647 );
+    CHECK( items[ 0 ].kind == 1 && items[ 0 ].weight == 0.5 && items[ 1 ].weight == -2.25 );
+    CHECK( items[ 0 ].pos.x == 1.0f && items[ 0 ].pos.z == 3.0f && items[ 1 ].pos.y == 0.0f );
+    CHECK( strcmp( items[ 0 ].name, "alpha" ) == 0 && strcmp( items[ 1 ].name, "beta" ) == 0 );
+
+    // Labels point into the array, strings are shared
+    CHECK( items[ 0 ].next == &items[ 2 ] && items[ 1 ].next == &items[ 0 ] );
+    CHECK( items[ 2 ].next->kind == 4 && items[ 2 ].next->next == NULL );
+    CHECK( items[ 2 ].name == items[ 0 ].name && table->tags[ 2 ] == items[ 1 ].name );
+    CHECK( strcmp( table->tags[ 1 ], "green" ) == 0 );
+
+    // Loading again changes nothing
+    CHECK( blob_load( testBlob ) == table && items[ 0 ].next == &items[ 2 ] );
+
+    // Moving an already loaded blob rebases it
+    copy = (BlobTable *)blob_load_copy( moved, testBlob );
+    CHECK( (u8 *)copy - (u8 *)moved == (u8 *)table - (u8 *)testBlob );
+    CHECK( copy->items != table->items && copy->items[ 0 ].next == &copy->items[ 2 ] );
+    CHECK( strcmp( copy->tags[ 0 ], "red" ) == 0 && copy->none == NULL );
+    CHECK( table->items[ 0 ].next == &table->items[ 2 ] );
+
+    // Room for exactly one copy
+    mem_init_arena( arena, (u8 *)arena + size );
+    copy = (BlobTable *)blob_load_arena( testBlob );
+    CHECK( copy && (u8 *)copy > (u8 *)arena && copy->items[ 1 ].next == &copy->items[ 0 ] );
+    CHECK( __mem_stats.arenaUsed == size );
+    CHECK( blob_load_arena( testBlob ) == NULL );
+
+    // Foreign data is refused
+    CHECK( blob_size( foreign ) == 0 && blob_load( foreign ) == NULL );
+}
+
+int main( void )
+{
+    test_memset( );
+    test_memcpy( );
+    test_memmove( );
+    test_memcmp( );
+    test_memchr( );
+    test_strlen_strcmp( );
+    test_destructor_chain( );
+    test_fragment_registry( );
+    test_stack_high_water( );
+    test_arena( );
+    test_cache_ranges( );
+    test_trace_ring( );
+    test_profile( );
+    test_fastmath( );
+    test_fibers( );
+    test_blob( );
+    test_containers( );
+    test_rel_loader( );
+
+    printf( "%d checks, %d failures\n", testChecks, testFailures );
+    return testFailures != 0;
+}
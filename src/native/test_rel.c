@@ -0,0 +1,235 @@
+// Host-side tests for src/runtime/rel_loader.c, called from test_main.c
+//
+// Modules are built by hand in host byte order, so the relocation arithmetic
+// is checked rather than dtk's output. The format holds 32-bit addresses, so
+// the images are mapped below 4 GB.
+
+#include <rel_loader.h>
+
+#include <sys/mman.h>
+
+#include "native_test.h"
+
+#define IMAGE_SIZE 0x400
+
+// Layout of every test image
+#define OFS_SECTIONS 0x050
+#define OFS_TEXT 0x080
+#define OFS_DATA 0x100
+#define OFS_IMPORTS 0x120
+#define OFS_RELOCS 0x140
+
+#define TEXT_SIZE 0x80
+#define DATA_SIZE 0x20
+#define BSS_SIZE 0x20
+
+enum
+{
+    SEC_NULL,
+    SEC_TEXT,
+    SEC_DATA,
+    SEC_BSS,
+    SEC_COUNT
+};
+
+// Addresses in the main DOL, the second one needs the @ha carry
+#define MAIN_SYM 0x80123454
+#define MAIN_SYM_HA 0x8012A5A4
+
+#define MASK24 0x03FFFFFC
+#define MASK14 0x0000FFFC
+
+static u8 *map_low( u32 size )
+{
+    void *p;
+
+#ifdef MAP_32BIT
+    p = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0 );
+#else
+    p = mmap( (void *)0x40000000, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+#endif
+    if( p == MAP_FAILED )
+    {
+        return NULL;
+    }
+    if( (uintptr_t)p + size - 1 > 0xFFFFFFFF )
+    {
+        munmap( p, size );
+        return NULL;
+    }
+    return (u8 *)p;
+}
+
+static RelHeader *init_image( u8 *image, u32 id )
+{
+    RelHeader *header = (RelHeader *)image;
+    RelSectionInfo *si = (RelSectionInfo *)( image + OFS_SECTIONS );
+
+    header->id = id;
+    header->numSections = SEC_COUNT;
+    header->sectionInfoOffset = OFS_SECTIONS;
+    header->version = 3;
+    header->bssSize = BSS_SIZE;
+    header->relOffset = OFS_RELOCS;
+    header->impOffset = OFS_IMPORTS;
+    header->align = 32;
+    header->bssAlign = 32;
+
+    si[ SEC_TEXT ].offset = OFS_TEXT | REL_SECTION_EXEC;
+    si[ SEC_TEXT ].size = TEXT_SIZE;
+    si[ SEC_DATA ].offset = OFS_DATA;
+    si[ SEC_DATA ].size = DATA_SIZE;
+    si[ SEC_BSS ].size = BSS_SIZE;
+    return header;
+}
+
+// Appends an import and returns where its relocations go
+static RelReloc *add_import( RelHeader *header, u32 id, RelReloc *rel )
+{
+    RelImport *imp = (RelImport *)( (u8 *)header + OFS_IMPORTS + header->impSize );
+
+    imp->id = id;
+    imp->offset = (u32)( (u8 *)rel - (u8 *)header );
+    header->impSize += sizeof( RelImport );
+    return rel;
+}
+
+static RelReloc *add_reloc( RelReloc *rel, u16 offset, u8 type, u8 section, u32 addend )
+{
+    rel->offset = offset;
+    rel->type = type;
+    rel->section = section;
+    rel->addend = addend;
+    return rel + 1;
+}
+
+static u32 addr( const void *p )
+{
+    return (u32)(uintptr_t)p;
+}
+
+static u32 *word( u8 *image, u32 offset )
+{
+    return (u32 *)( image + offset );
+}
+
+static u16 *half( u8 *image, u32 offset )
+{
+    return (u16 *)( image + offset );
+}
+
+void test_rel_loader( void )
+{
+    u8 *mem = map_low( 4 * IMAGE_SIZE );
+    u8 *a;
+    u8 *b;
+    u8 *bss;
+    u8 *text;
+    RelHeader *modA;
+    RelHeader *modB;
+    RelReloc *rel;
+
+    if( mem == NULL )
+    {
+        printf( "test_rel_loader: no memory below 4 GB, skipped\n" );
+        return;
+    }
+    a = mem;
+    b = mem + IMAGE_SIZE;
+    bss = mem + 2 * IMAGE_SIZE;
+    text = a + OFS_TEXT;
+
+    // Module 1 relocates against the main DOL and itself, once per type
+    modA = init_image( a, 1 );
+    *word( text, 0x04 ) = 0x48000003; // bla
+    *word( text, 0x18 ) = 0x41820001; // beql
+    *word( text, 0x1C ) = 0x41A20001;
+    *word( text, 0x20 ) = 0x41820000;
+    *word( text, 0x34 ) = 0x48000001; // bl
+    *word( text, 0x38 ) = 0x40820000; // bne
+    *word( text, 0x44 ) = 0x48000001;
+    *word( text, 0x48 ) = 0xDEADBEEF;
+
+    rel = add_import( modA, 0, (RelReloc *)( a + OFS_RELOCS ) );
+    rel = add_reloc( rel, 0, R_DOLPHIN_SECTION, SEC_TEXT, 0 );
+    rel = add_reloc( rel, 0x00, R_PPC_ADDR32, 0, MAIN_SYM );
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR24, 0, MAIN_SYM );
+    rel = add_reloc( rel, 0x06, R_PPC_ADDR16, 0, MAIN_SYM );             // 0x0A
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR16_LO, 0, MAIN_SYM_HA );       // 0x0E
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR16_HI, 0, MAIN_SYM_HA );       // 0x12
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR16_HA, 0, MAIN_SYM_HA );       // 0x16
+    rel = add_reloc( rel, 0x02, R_PPC_ADDR14, 0, 0x1234 );               // 0x18
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR14_BRTAKEN, 0, 0x2468 );       // 0x1C
+    rel = add_reloc( rel, 0x04, R_PPC_ADDR14_BRNTAKEN, 0, 0x1230 );      // 0x20
+    rel = add_reloc( rel, 0x10, R_DOLPHIN_NOP, 0, 0 );                   // 0x30
+    rel = add_reloc( rel, 0x04, R_PPC_REL24, 0, MAIN_SYM );              // 0x34
+    rel = add_reloc( rel, 0x04, R_PPC_REL14, 0, addr( text ) + 0x100 );  // 0x38
+    rel = add_reloc( rel, 0x04, R_PPC_REL32, 0, MAIN_SYM );              // 0x3C
+    rel = add_reloc( rel, 0, R_DOLPHIN_END, 0, 0 );
+
+    rel = add_import( modA, 1, rel );
+    rel = add_reloc( rel, 0, R_DOLPHIN_SECTION, SEC_TEXT, 0 );
+    rel = add_reloc( rel, 0x40, R_PPC_ADDR32, SEC_BSS, 8 );
+    rel = add_reloc( rel, 0x04, R_PPC_REL24, SEC_DATA, 0x10 ); // 0x44
+    rel = add_reloc( rel, 0x04, 99, SEC_DATA, 0 );             // 0x48, unknown type
+    rel = add_reloc( rel, 0, R_DOLPHIN_END, 0, 0 );
+
+    // Module 2 only imports from module 1; calls into it fall back to
+    // _unresolved at text + 0x20 while module 1 isn't linked
+    modB = init_image( b, 2 );
+    modB->bssSize = 0;
+    ( (RelSectionInfo *)( b + OFS_SECTIONS ) )[ SEC_BSS ].size = 0;
+    modB->unresolvedSection = SEC_TEXT;
+    modB->unresolved = 0x20;
+    *word( b + OFS_TEXT, 0x04 ) = 0x48000001;
+    rel = add_import( modB, 1, (RelReloc *)( b + OFS_RELOCS ) );
+    rel = add_reloc( rel, 0, R_DOLPHIN_SECTION, SEC_TEXT, 0 );
+    rel = add_reloc( rel, 0x00, R_PPC_ADDR32, SEC_DATA, 4 );
+    rel = add_reloc( rel, 0x04, R_PPC_REL24, SEC_TEXT, 0x10 );
+    rel = add_reloc( rel, 0, R_DOLPHIN_END, 0, 0 );
+
+    // Rejected before anything is touched
+    CHECK( !rel_link( modA, bss + 4 ) );
+    modA->version = 4;
+    CHECK( !rel_link( modA, bss ) );
+    modA->version = 3;
+    CHECK( modA->sectionInfoOffset == OFS_SECTIONS );
+
+    // Module 2 first: its import from module 1 waits
+    CHECK( rel_link( modB, NULL ) );
+    CHECK( *word( b + OFS_TEXT, 0x00 ) == 0 );
+
+    bss[ 0 ] = 0xAA;
+    CHECK( rel_link( modA, bss ) );
+    CHECK( bss[ 0 ] == 0 );
+    CHECK( modA->bssSection == SEC_BSS );
+
+    CHECK( *word( text, 0x00 ) == MAIN_SYM );
+    CHECK( *word( text, 0x04 ) == ( 0x48000003 | ( MAIN_SYM & MASK24 ) ) );
+    CHECK( *half( text, 0x0A ) == ( MAIN_SYM & 0xFFFF ) );
+    CHECK( *half( text, 0x0E ) == 0xA5A4 );
+    CHECK( *half( text, 0x12 ) == 0x8012 );
+    CHECK( *half( text, 0x16 ) == 0x8013 );
+    CHECK( *word( text, 0x18 ) == ( 0x41820001 | 0x1234 ) );
+    CHECK( *word( text, 0x1C ) == ( 0x41A20001 | 0x2468 ) );
+    CHECK( *word( text, 0x20 ) == ( 0x41820000 | 0x1230 ) );
+    CHECK( *word( text, 0x34 ) == ( 0x48000001 | ( ( MAIN_SYM - addr( text + 0x34 ) ) & MASK24 ) ) );
+    CHECK( *word( text, 0x38 ) == ( 0x40820000 | ( 0x100 - 0x38 ) ) );
+    CHECK( *word( text, 0x3C ) == MAIN_SYM - addr( text + 0x3C ) );
+    CHECK( *word( text, 0x40 ) == addr( bss + 8 ) );
+    CHECK( *word( text, 0x44 ) == ( 0x48000001 | ( ( OFS_DATA + 0x10 - OFS_TEXT - 0x44 ) & MASK24 ) ) );
+    CHECK( *word( text, 0x48 ) == 0xDEADBEEF );
+
+    // Linking module 1 patched module 2's import
+    CHECK( *word( b + OFS_TEXT, 0x00 ) == addr( a + OFS_DATA + 4 ) );
+    CHECK( *word( b + OFS_TEXT, 0x04 ) == ( 0x48000001 | ( ( addr( text + 0x10 ) - addr( b + OFS_TEXT + 4 ) ) & MASK24 ) ) );
+
+    // Unlinking points module 2 back at its _unresolved
+    CHECK( rel_unlink( modA ) );
+    CHECK( *word( b + OFS_TEXT, 0x00 ) == 0 );
+    CHECK( *word( b + OFS_TEXT, 0x04 ) == ( 0x48000001 | ( ( 0x20 - 0x04 ) & MASK24 ) ) );
+    CHECK( modA->next == 0 && modA->prev == 0 && modB->next == 0 );
+
+    CHECK( rel_unlink( modB ) );
+    munmap( mem, 4 * IMAGE_SIZE );
+}
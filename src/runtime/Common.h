@@ -7,18 +7,29 @@
 
 typedef signed char s8;
 typedef signed short s16;
-typedef signed long s32;
 typedef signed long long s64;
 typedef unsigned char u8;
 typedef unsigned short u16;
-typedef unsigned long u32;
 typedef unsigned long long u64;
 
 typedef float f32;
 typedef float f64;
 
+#ifdef __MWERKS__
+typedef signed long s32;
+typedef unsigned long u32;
+
 typedef u32 size_t;
 typedef u32 uintptr_t;
+#else
+// Native builds (`ninja native`) run on LP64 hosts, keep u32 at 32
+// bits and size_t compatible with the system headers
+typedef signed int s32;
+typedef unsigned int u32;
+
+typedef __SIZE_TYPE__ size_t;
+typedef __UINTPTR_TYPE__ uintptr_t;
+#endif
 typedef void ( *funcptr_t )( void );
 
 typedef int BOOL;
@@ -28,10 +39,17 @@ enum
     TRUE
 };
 
+#ifndef NULL
 #define NULL 0
+#endif
 
+#ifdef __MWERKS__
 #define __DECL_SECTION( x ) __declspec( section x )
 #define __DECL_WEAK __declspec( weak )
+#else
+#define __DECL_SECTION( x )
+#define __DECL_WEAK __attribute__( ( weak ) )
+#endif
 
 /* ================================ *
  *     C++ DEFINITIONS
@@ -42,7 +60,13 @@ extern "C"
 {
 #endif
 
+#ifdef __MWERKS__
 #define static_assert( cond ) __static_assert( cond, #cond )
+#elif defined( __cplusplus )
+#define static_assert( cond ) static_assert( cond, #cond )
+#else
+#define static_assert( cond ) _Static_assert( cond, #cond )
+#endif
 
 #ifdef __cplusplus
 }
@@ -1,7 +1,11 @@
 #include <Common.h>
+#include <trace.h>
 extern "C"
 {
   #include "sample_functions.h"
+#ifdef BENCH
+  #include "benchmarks.h"
+#endif
 }
 
 void *operator new( size_t size )
@@ -24,6 +28,13 @@ static __Sample __sample;
 int main( void )
 {
     __sample._0 = 0xf3;
+    trace_reset( );
+#ifdef BENCH
+    run_benchmarks( );
+#else
+    TRACE_BEGIN( sample_funcs );
     sample_funcs();
+    TRACE_END( sample_funcs );
+#endif
     return 0;
 }
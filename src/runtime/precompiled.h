@@ -0,0 +1,24 @@
+#ifndef PRECOMPILED_H
+#define PRECOMPILED_H
+
+// Precompiled once per compiler version, flag set and language by
+// configure.py and passed to every object with `-prefix`. Only headers that
+// don't depend on the chapter sources belong here; the include guards make
+// each TU's own #includes of them free.
+
+#include <Common.h>
+
+#include <rel_loader.h>
+#include <runtime_cache.h>
+#include <runtime_core.h>
+#include <runtime_exception.h>
+#include <runtime_fiber.h>
+#include <runtime_mem.h>
+#include <runtime_time.h>
+#include <trace.h>
+
+#include <bench.h>
+#include <profile.h>
+#include <stuff.h>
+
+#endif
@@ -0,0 +1,328 @@
+#include <rel_loader.h>
+#include <runtime_cache.h>
+#include <runtime_core.h>
+
+/* ================================ *
+ *     OSLink.c
+ * ================================ */
+
+static RelHeader *relFirst;
+static RelHeader *relLast;
+
+// Between the 32-bit addresses in a linked image and host pointers
+#define REL_PTR( type, addr ) ( (type)(uintptr_t)( addr ) )
+#define REL_ADDR( ptr ) ( (u32)(uintptr_t)( ptr ) )
+
+static RelSectionInfo *rel_sections( const RelHeader *module )
+{
+    return REL_PTR( RelSectionInfo *, module->sectionInfoOffset );
+}
+
+// Ranges patched since the last rel_flush, synced together so a whole link
+// or unlink pays for the cache barriers once
+#define REL_MAX_DIRTY 16
+
+static CacheRange relDirty[ REL_MAX_DIRTY ];
+static u32 relDirtyCount;
+
+static void rel_flush( void )
+{
+    ICSyncRangeList( relDirty, relDirtyCount );
+    relDirtyCount = 0;
+}
+
+static void rel_mark_dirty( u32 lo, u32 hi )
+{
+    if( lo > hi )
+    {
+        return;
+    }
+
+    if( relDirtyCount == REL_MAX_DIRTY )
+    {
+        rel_flush( );
+    }
+    relDirty[ relDirtyCount ].addr = REL_PTR( void *, lo );
+    relDirty[ relDirtyCount ].nBytes = hi + 4 - lo;
+    ++relDirtyCount;
+}
+
+// Walks one relocation list front to back. dtk sorts every list by section
+// and offset, so each entry is applied relative to the previous one and no
+// searching is needed. `imported` is NULL for the main DOL, whose addends are
+// already absolute. With `undo` set, references are cut loose instead.
+static void rel_relocate( RelHeader *module, const RelImport *imp, const RelHeader *imported, BOOL undo )
+{
+    const RelSectionInfo *sections = rel_sections( module );
+    const RelSectionInfo *target = imported ? rel_sections( imported ) : NULL;
+    const RelReloc *rel = REL_PTR( const RelReloc *, imp->offset );
+    u32 lo = 0xFFFFFFFF;
+    u32 hi = 0;
+    u32 p = 0;
+    u32 s;
+    u32 *w;
+
+    for( ;; ++rel )
+    {
+        if( rel->type == R_DOLPHIN_SECTION )
+        {
+            p = REL_SECTION_OFFSET( &sections[ rel->section ] );
+            continue;
+        }
+
+        p += rel->offset;
+        if( rel->type == R_DOLPHIN_NOP )
+        {
+            continue;
+        }
+        if( rel->type == R_DOLPHIN_END )
+        {
+            break;
+        }
+
+        if( undo )
+        {
+            s = rel->type == R_PPC_REL24 ? module->unresolved : 0;
+        }
+        else if( target )
+        {
+            s = REL_SECTION_OFFSET( &target[ rel->section ] ) + rel->addend;
+        }
+        else
+        {
+            s = rel->addend;
+        }
+
+        w = REL_PTR( u32 *, p & ~3 );
+        switch( rel->type )
+        {
+        case R_PPC_ADDR32:
+            *REL_PTR( u32 *, p ) = s;
+            break;
+        case R_PPC_ADDR24:
+            *w = ( *w & ~0x03FFFFFC ) | ( s & 0x03FFFFFC );
+            break;
+        case R_PPC_ADDR16:
+        case R_PPC_ADDR16_LO:
+            *REL_PTR( u16 *, p ) = (u16)s;
+            break;
+        case R_PPC_ADDR16_HI:
+            *REL_PTR( u16 *, p ) = (u16)( s >> 16 );
+            break;
+        case R_PPC_ADDR16_HA:
+            *REL_PTR( u16 *, p ) = (u16)( ( s + 0x8000 ) >> 16 );
+            break;
+        case R_PPC_ADDR14:
+        case R_PPC_ADDR14_BRTAKEN:
+        case R_PPC_ADDR14_BRNTAKEN:
+            *w = ( *w & ~0xFFFC ) | ( s & 0xFFFC );
+            break;
+        case R_PPC_REL24:
+            *w = ( *w & ~0x03FFFFFC ) | ( ( s - p ) & 0x03FFFFFC );
+            break;
+        case R_PPC_REL14:
+        case R_PPC_REL14_BRTAKEN:
+        case R_PPC_REL14_BRNTAKEN:
+            *w = ( *w & ~0xFFFC ) | ( ( s - p ) & 0xFFFC );
+            break;
+        case R_PPC_REL32:
+            *REL_PTR( u32 *, p ) = s - p;
+            break;
+        default:
+            continue;
+        }
+
+        if( p < lo )
+        {
+            lo = p;
+        }
+        if( p > hi )
+        {
+            hi = p;
+        }
+    }
+
+    rel_mark_dirty( lo, hi );
+}
+
+static RelHeader *rel_find( u32 id )
+{
+    RelHeader *module;
+
+    for( module = relFirst; module; module = REL_PTR( RelHeader *, module->next ) )
+    {
+        if( module->id == id )
+        {
+            return module;
+        }
+    }
+
+    return NULL;
+}
+
+// Applies `module`'s relocations against the main DOL and all loaded modules
+static void rel_resolve_imports( RelHeader *module )
+{
+    const RelImport *imp = REL_PTR( const RelImport *, module->impOffset );
+    const RelImport *end = REL_PTR( const RelImport *, module->impOffset + module->impSize );
+    RelHeader *imported;
+
+    for( ; imp < end; ++imp )
+    {
+        if( imp->id == 0 )
+        {
+            rel_relocate( module, imp, NULL, FALSE );
+        }
+        else if( ( imported = rel_find( imp->id ) ) != NULL )
+        {
+            rel_relocate( module, imp, imported, FALSE );
+        }
+    }
+}
+
+// Applies (or undoes) every other module's relocations against `module`
+static void rel_resolve_exports( RelHeader *module, BOOL undo )
+{
+    RelHeader *other;
+    const RelImport *imp;
+    const RelImport *end;
+
+    for( other = relFirst; other; other = REL_PTR( RelHeader *, other->next ) )
+    {
+        if( other == module )
+        {
+            continue;
+        }
+
+        imp = REL_PTR( const RelImport *, other->impOffset );
+        end = REL_PTR( const RelImport *, other->impOffset + other->impSize );
+        for( ; imp < end; ++imp )
+        {
+            if( imp->id == module->id )
+            {
+                rel_relocate( other, imp, module, undo );
+            }
+        }
+    }
+}
+
+BOOL rel_link( RelHeader *module, void *bss )
+{
+    u32 base = REL_ADDR( module );
+    RelSectionInfo *si;
+    RelImport *imp;
+    u32 i;
+
+    if( module->version > 3 )
+    {
+        return FALSE;
+    }
+    if( module->version >= 2 )
+    {
+        if( ( module->align && base % module->align ) ||
+                ( module->bssAlign && REL_ADDR( bss ) % module->bssAlign ) )
+        {
+            return FALSE;
+        }
+    }
+
+    // File offsets to pointers
+    module->sectionInfoOffset += base;
+    if( module->nameOffset )
+    {
+        module->nameOffset += base;
+    }
+    module->relOffset += base;
+    module->impOffset += base;
+    for( imp = REL_PTR( RelImport *, module->impOffset ); REL_ADDR( imp ) < module->impOffset + module->impSize; ++imp )
+    {
+        imp->offset += base;
+    }
+
+    si = rel_sections( module );
+    for( i = 1; i < module->numSections; ++i )
+    {
+        if( si[ i ].offset )
+        {
+            si[ i ].offset += base;
+        }
+        else if( si[ i ].size )
+        {
+            module->bssSection = (u8)i;
+            si[ i ].offset = REL_ADDR( bss );
+        }
+    }
+
+    if( module->bssSize )
+    {
+        memset( bss, 0, module->bssSize );
+    }
+    if( module->prologSection )
+    {
+        module->prolog += REL_SECTION_OFFSET( &si[ module->prologSection ] );
+    }
+    if( module->epilogSection )
+    {
+        module->epilog += REL_SECTION_OFFSET( &si[ module->epilogSection ] );
+    }
+    if( module->unresolvedSection )
+    {
+        module->unresolved += REL_SECTION_OFFSET( &si[ module->unresolvedSection ] );
+    }
+
+    module->next = 0;
+    module->prev = REL_ADDR( relLast );
+    if( relLast )
+    {
+        relLast->next = base;
+    }
+    else
+    {
+        relFirst = module;
+    }
+    relLast = module;
+
+    rel_resolve_imports( module );
+    rel_resolve_exports( module, FALSE );
+    rel_flush( );
+
+    // The module's _prolog runs its constructors and registers its extab
+    if( module->prolog )
+    {
+        REL_PTR( funcptr_t, module->prolog )( );
+    }
+
+    return TRUE;
+}
+
+BOOL rel_unlink( RelHeader *module )
+{
+    if( module->epilog )
+    {
+        REL_PTR( funcptr_t, module->epilog )( );
+    }
+
+    rel_resolve_exports( module, TRUE );
+    rel_flush( );
+
+    if( module->next )
+    {
+        REL_PTR( RelHeader *, module->next )->prev = module->prev;
+    }
+    else
+    {
+        relLast = REL_PTR( RelHeader *, module->prev );
+    }
+    if( module->prev )
+    {
+        REL_PTR( RelHeader *, module->prev )->next = module->next;
+    }
+    else
+    {
+        relFirst = REL_PTR( RelHeader *, module->next );
+    }
+
+    module->next = 0;
+    module->prev = 0;
+    return TRUE;
+}
@@ -0,0 +1,116 @@
+#ifndef REL_LOADER_H
+#define REL_LOADER_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     REL format
+ * ================================ */
+
+// Layout of the relocatable modules written by `dtk rel make` (version 1-3).
+// Addresses are 32 bits wide in the format, rel_link stores them back into
+// these fields, so an image must sit below 4 GB (always true on the target).
+
+typedef struct RelSectionInfo
+{
+    u32 offset; // Bit 0 set for executable sections, 0 for bss/unused
+    u32 size;
+} RelSectionInfo;
+
+#define REL_SECTION_EXEC 1
+#define REL_SECTION_OFFSET( s ) ( ( s )->offset & ~REL_SECTION_EXEC )
+
+typedef struct RelImport
+{
+    u32 id;     // Module the relocations refer to, 0 for the main DOL
+    u32 offset; // Relocation list
+} RelImport;
+
+typedef struct RelReloc
+{
+    u16 offset; // Distance from the previous relocation
+    u8 type;
+    u8 section;
+    u32 addend;
+} RelReloc;
+
+enum
+{
+    R_PPC_NONE = 0,
+    R_PPC_ADDR32 = 1,
+    R_PPC_ADDR24 = 2,
+    R_PPC_ADDR16 = 3,
+    R_PPC_ADDR16_LO = 4,
+    R_PPC_ADDR16_HI = 5,
+    R_PPC_ADDR16_HA = 6,
+    R_PPC_ADDR14 = 7,
+    R_PPC_ADDR14_BRTAKEN = 8,
+    R_PPC_ADDR14_BRNTAKEN = 9,
+    R_PPC_REL24 = 10,
+    R_PPC_REL14 = 11,
+    R_PPC_REL14_BRTAKEN = 12,
+    R_PPC_REL14_BRNTAKEN = 13,
+    R_PPC_REL32 = 26,
+
+    R_DOLPHIN_NOP = 201,
+    R_DOLPHIN_SECTION = 202,
+    R_DOLPHIN_END = 203
+};
+
+typedef struct RelHeader
+{
+    u32 id;
+    u32 next; // RelHeader * in the loaded list
+    u32 prev;
+    u32 numSections;
+    u32 sectionInfoOffset;
+    u32 nameOffset;
+    u32 nameSize;
+    u32 version;
+
+    u32 bssSize;
+    u32 relOffset;
+    u32 impOffset;
+    u32 impSize;
+    u8 prologSection;
+    u8 epilogSection;
+    u8 unresolvedSection;
+    u8 bssSection;
+    u32 prolog;
+    u32 epilog;
+    u32 unresolved;
+
+    // Version 2
+    u32 align;
+    u32 bssAlign;
+
+    // Version 3
+    u32 fixSize;
+} RelHeader;
+
+static_assert( sizeof( RelHeader ) == 0x4C );
+
+/* ================================ *
+ *     Loader
+ * ================================ */
+
+// Links a module image that is already in memory: offsets become pointers,
+// relocations against the main DOL, itself and every loaded module are
+// applied, and its _prolog runs. bss must hold header->bssSize bytes aligned
+// to bssAlign. Modules loaded later are linked against this one in turn.
+BOOL rel_link( RelHeader *module, void *bss );
+
+// Runs _epilog and removes the module from the loaded list, references from
+// other modules are pointed back at their _unresolved.
+BOOL rel_unlink( RelHeader *module );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#include <runtime_exception.h>
+
+/* ================================ *
+ *     Module prolog/epilog
+ * ================================ */
+
+// Linked into every REL module, rel_link calls _prolog once the module is
+// relocated and rel_unlink calls _epilog before removing it.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+void _prolog( void );
+void _epilog( void );
+void _unresolved( void );
+#ifdef __cplusplus
+}
+#endif
+
+extern funcptr_t _ctors[];
+extern funcptr_t _dtors[];
+extern const ExtabIndexInfo _eti_init_info[];
+
+static int moduleFragmentID = -1;
+
+static void *GetTOC( void )
+{
+    register void *toc;
+
+    // clang-format off
+    asm
+    {
+        mr toc, r2
+    };
+    // clang-format on
+
+    return toc;
+}
+
+void _prolog( void )
+{
+    funcptr_t *ctor;
+
+    // Register the module's extab first so constructors may throw
+    moduleFragmentID = __register_fragment( _eti_init_info, GetTOC( ) );
+
+    for( ctor = _ctors; *ctor; ++ctor )
+    {
+        ( *ctor )( );
+    }
+}
+
+void _epilog( void )
+{
+    funcptr_t *dtor;
+
+    for( dtor = _dtors; *dtor; ++dtor )
+    {
+        ( *dtor )( );
+    }
+
+    if( moduleFragmentID >= 0 )
+    {
+        __unregister_fragment( moduleFragmentID );
+        moduleFragmentID = -1;
+    }
+}
+
+void _unresolved( void )
+{
+    // A call into a module that is not loaded, stop here
+    for( ;; )
+    {
+    }
+}
@@ -0,0 +1,197 @@
+#include <runtime_cache.h>
+#include <runtime_core.h>
+
+/* ================================ *
+ *     OSCache.c
+ * ================================ */
+
+#ifdef __MWERKS__
+
+// Block loops take a block-aligned start and a non-zero count
+
+asm static void dc_flush_blocks( register u8 *p, register u32 n )
+{
+    // clang-format off
+    nofralloc
+
+    mtctr r4
+loop:
+    dcbf 0, r3
+    addi r3, r3, CACHE_BLOCK_SIZE
+    bdnz loop
+    blr
+    // clang-format on
+}
+
+asm static void dc_store_blocks( register u8 *p, register u32 n )
+{
+    // clang-format off
+    nofralloc
+
+    mtctr r4
+loop:
+    dcbst 0, r3
+    addi r3, r3, CACHE_BLOCK_SIZE
+    bdnz loop
+    blr
+    // clang-format on
+}
+
+asm static void dc_zero_blocks( register u8 *p, register u32 n )
+{
+    // clang-format off
+    nofralloc
+
+    mtctr r4
+loop:
+    dcbz 0, r3
+    addi r3, r3, CACHE_BLOCK_SIZE
+    bdnz loop
+    blr
+    // clang-format on
+}
+
+asm static void ic_invalidate_blocks( register u8 *p, register u32 n )
+{
+    // clang-format off
+    nofralloc
+
+    mtctr r4
+loop:
+    icbi 0, r3
+    addi r3, r3, CACHE_BLOCK_SIZE
+    bdnz loop
+    blr
+    // clang-format on
+}
+
+asm static void cache_sync( void )
+{
+    // clang-format off
+    nofralloc
+
+    sync
+    blr
+    // clang-format on
+}
+
+// Discards instructions prefetched before the icbi took effect
+asm static void cache_isync( void )
+{
+    // clang-format off
+    nofralloc
+
+    sync
+    isync
+    blr
+    // clang-format on
+}
+
+#else
+
+// Host caches are coherent, only dcbz has a visible effect
+
+static void dc_flush_blocks( u8 *p, u32 n ) {}
+static void dc_store_blocks( u8 *p, u32 n ) {}
+static void ic_invalidate_blocks( u8 *p, u32 n ) {}
+static void cache_sync( void ) {}
+static void cache_isync( void ) {}
+
+static void dc_zero_blocks( u8 *p, u32 n )
+{
+    memset( p, 0, n * CACHE_BLOCK_SIZE );
+}
+
+#endif
+
+u32 CacheBlockCount( const void *addr, u32 nBytes )
+{
+    if( nBytes == 0 )
+    {
+        return 0;
+    }
+    return (u32)( ( (uintptr_t)addr + nBytes - 1 - CACHE_BLOCK_START( addr ) ) / CACHE_BLOCK_SIZE ) + 1;
+}
+
+void DCFlushRange( void *addr, u32 nBytes )
+{
+    u32 n = CacheBlockCount( addr, nBytes );
+
+    if( n )
+    {
+        dc_flush_blocks( (u8 *)CACHE_BLOCK_START( addr ), n );
+        cache_sync( );
+    }
+}
+
+void DCStoreRange( void *addr, u32 nBytes )
+{
+    u32 n = CacheBlockCount( addr, nBytes );
+
+    if( n )
+    {
+        dc_store_blocks( (u8 *)CACHE_BLOCK_START( addr ), n );
+        cache_sync( );
+    }
+}
+
+void DCZeroRange( void *addr, u32 nBytes )
+{
+    u32 n = CacheBlockCount( addr, nBytes );
+
+    if( n )
+    {
+        dc_zero_blocks( (u8 *)CACHE_BLOCK_START( addr ), n );
+    }
+}
+
+void ICInvalidateRange( void *addr, u32 nBytes )
+{
+    u32 n = CacheBlockCount( addr, nBytes );
+
+    if( n )
+    {
+        ic_invalidate_blocks( (u8 *)CACHE_BLOCK_START( addr ), n );
+        cache_isync( );
+    }
+}
+
+void ICSyncRange( void *addr, u32 nBytes )
+{
+    CacheRange range;
+
+    range.addr = addr;
+    range.nBytes = nBytes;
+    ICSyncRangeList( &range, 1 );
+}
+
+void ICSyncRangeList( const CacheRange *ranges, u32 count )
+{
+    u32 i;
+    u32 n;
+    BOOL any = FALSE;
+
+    // Stores must reach memory before icbi makes fetch reread it
+    for( i = 0; i < count; ++i )
+    {
+        if( n = CacheBlockCount( ranges[ i ].addr, ranges[ i ].nBytes ) )
+        {
+            dc_store_blocks( (u8 *)CACHE_BLOCK_START( ranges[ i ].addr ), n );
+            any = TRUE;
+        }
+    }
+    if( !any )
+    {
+        return;
+    }
+    cache_sync( );
+
+    for( i = 0; i < count; ++i )
+    {
+        if( n = CacheBlockCount( ranges[ i ].addr, ranges[ i ].nBytes ) )
+        {
+            ic_invalidate_blocks( (u8 *)CACHE_BLOCK_START( ranges[ i ].addr ), n );
+        }
+    }
+    cache_isync( );
+}
@@ -0,0 +1,55 @@
+#ifndef RUNTIME_CACHE_H
+#define RUNTIME_CACHE_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     OSCache.h
+ * ================================ */
+
+// Gekko L1 caches work on 32-byte blocks. Every range is widened to the
+// blocks it touches, so unaligned ends also affect their neighbours.
+
+#define CACHE_BLOCK_SIZE 32
+#define CACHE_BLOCK_START( addr ) ( (uintptr_t)( addr ) & ~( CACHE_BLOCK_SIZE - 1 ) )
+
+typedef struct CacheRange
+{
+    void *addr;
+    u32 nBytes;
+} CacheRange;
+
+// Number of blocks [addr, addr + nBytes) touches, 0 for an empty range
+u32 CacheBlockCount( const void *addr, u32 nBytes );
+
+// Writes dirty blocks back and invalidates them (dcbf), then syncs so the
+// data is in memory before e.g. a DMA reads it
+void DCFlushRange( void *addr, u32 nBytes );
+
+// Writes dirty blocks back but keeps them cached (dcbst), then syncs
+void DCStoreRange( void *addr, u32 nBytes );
+
+// Zeroes whole blocks in the cache without reading memory first (dcbz)
+void DCZeroRange( void *addr, u32 nBytes );
+
+// Drops stale instructions (icbi), then sync/isync so fetch sees memory
+void ICInvalidateRange( void *addr, u32 nBytes );
+
+// Makes instructions written through the data cache executable: dcbst, sync,
+// icbi, sync, isync
+void ICSyncRange( void *addr, u32 nBytes );
+
+// ICSyncRange for several ranges with one barrier per pass instead of one
+// per range
+void ICSyncRangeList( const CacheRange *ranges, u32 count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
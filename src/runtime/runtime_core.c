@@ -1,5 +1,7 @@
+#include <runtime_cache.h>
 #include <runtime_core.h>
 #include <runtime_exception.h>
+#include <runtime_mem.h>
 
 int main( int argc, char **argv );
 
@@ -31,6 +33,9 @@ __DECL_SECTION( ".init" ) void *memcpy( void *dst, const void *src, size_t n )
     return dst;
 }
 
+// Startup code below is target-only, native builds get memset/memcpy
+#ifdef __MWERKS__
+
 __DECL_SECTION( ".init" ) asm static void __init_registers( void )
 {
     // clang-format off
@@ -90,6 +95,8 @@ __DECL_SECTION( ".init" ) static void __copy_rom_section( void *dst, const void
     if( n != 0 && dst != src )
     {
         memcpy( dst, src, n );
+        // Copied sections may hold code
+        ICSyncRange( dst, n );
     }
 }
 
@@ -175,8 +182,11 @@ asm void __start( void )
 
     bl __init_registers
     bl __init_data
+    bl __init_mem
     bl __init_cpp
     bl main
     b exit
     // clang-format on
 }
+
+#endif
@@ -6,7 +6,17 @@
 void *memset( void *s, int c, size_t n );
 void *memcpy( void *dst, const void *src, size_t n );
 
+// runtime_string.c
+void *memmove( void *dst, const void *src, size_t n );
+int memcmp( const void *a, const void *b, size_t n );
+void *memchr( const void *s, int c, size_t n );
+size_t strlen( const char *s );
+int strcmp( const char *a, const char *b );
+
 __DECL_SECTION( ".init" ) extern u8 _stack_addr[];
+__DECL_SECTION( ".init" ) extern u8 _stack_end[];
+__DECL_SECTION( ".init" ) extern u8 __ArenaLo[];
+__DECL_SECTION( ".init" ) extern u8 __ArenaHi[];
 __DECL_SECTION( ".init" ) extern u8 _SDA_BASE_[];
 __DECL_SECTION( ".init" ) extern u8 _SDA2_BASE_[];
 
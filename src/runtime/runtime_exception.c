@@ -4,15 +4,6 @@
  *     global_destructor_chain.c
  * ================================ */
 
-typedef void ( *DtorFunc )( void *obj, s16 method );
-
-typedef struct DtorLink
-{
-    struct DtorLink *next;
-    DtorFunc dtor;
-    void *obj;
-} DtorLink;
-
 DtorLink *__global_destructor_chain = NULL;
 
 void __register_global_object( void *obj, DtorFunc dtor, DtorLink *link )
@@ -34,16 +25,16 @@ void __destroy_global_chain( void )
     }
 }
 
+#ifdef __MWERKS__
 #pragma section ".dtors$10"
 __DECL_SECTION( ".dtors$10" )
 __DECL_WEAK const funcptr_t __destroy_global_chain_reference = __destroy_global_chain;
+#endif
 
 /* ================================ *
  *     Gecko_ExceptionPPC.c
  * ================================ */
 
-#define NUM_FRAGMENT 1
-
 typedef struct FragmentInfo
 {
     const ExtabIndexInfo *eti;
@@ -66,7 +57,7 @@ int __register_fragment( const ExtabIndexInfo *eti, void *toc )
             frag->eti = eti;
             frag->toc = toc;
             frag->regist = TRUE;
-            return 0;
+            return i;
         }
     }
 
@@ -91,6 +82,9 @@ void __unregister_fragment( int i )
  *     __init_cpp_exceptions.cpp
  * ================================ */
 
+// Target-only, native builds use the destructor chain and registry above
+#ifdef __MWERKS__
+
 static int fragmentID = -2;
 
 #ifdef __cplusplus
@@ -141,3 +135,4 @@ const funcptr_t __init_cpp_exceptions_reference = __init_cpp_exceptions;
 #pragma section ".dtors$15"
 __DECL_SECTION( ".dtors$15" )
 const funcptr_t __fini_cpp_exceptions_reference = __fini_cpp_exceptions;
+#endif
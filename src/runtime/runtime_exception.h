@@ -12,6 +12,16 @@ extern "C"
 {
 #endif
 
+typedef void ( *DtorFunc )( void *obj, s16 method );
+
+typedef struct DtorLink
+{
+    struct DtorLink *next;
+    DtorFunc dtor;
+    void *obj;
+} DtorLink;
+
+void __register_global_object( void *obj, DtorFunc dtor, DtorLink *link );
 void __destroy_global_chain( void );
 
 #ifdef __cplusplus
@@ -27,6 +37,9 @@ extern "C"
 {
 #endif
 
+// The main DOL plus every REL module that can be linked at the same time
+#define NUM_FRAGMENT 8
+
 // Forward declarations
 typedef struct ExtabIndexInfo
 {
@@ -0,0 +1,269 @@
+#include <runtime_core.h>
+#include <runtime_fiber.h>
+#include <runtime_mem.h>
+
+#ifndef __MWERKS__
+#include <stdlib.h>
+#endif
+
+static Fiber fiberMain;
+static Fiber *fiberCurrent;
+static Fiber *readyHead;
+static Fiber *readyTail;
+static u32 readyCount;
+
+/* ================================ *
+ *     Context switch
+ * ================================ */
+
+#ifdef __MWERKS__
+
+void PPCHalt( void ); // runtime_core.c
+
+static_assert( sizeof( FiberContext ) == 0xE8 );
+
+// Saves the non-volatile state to `from` and restores `to`, returning from
+// the fiber_switch call `to` saved, or into fiber_entry for a new fiber.
+// 50 instructions, mostly the 36 FPR loads and stores; the bench DOL's
+// fiber_switch_x64 case times it together with fiber_yield.
+asm static void fiber_switch( register FiberContext *from, register FiberContext *to )
+{
+    // clang-format off
+    nofralloc
+
+    mflr r0
+    mfcr r5
+    stw r1, 0x00(r3)
+    stw r0, 0x04(r3)
+    stw r5, 0x08(r3)
+    stmw r14, 0x0C(r3)
+    stfd f14, 0x58(r3)
+    stfd f15, 0x60(r3)
+    stfd f16, 0x68(r3)
+    stfd f17, 0x70(r3)
+    stfd f18, 0x78(r3)
+    stfd f19, 0x80(r3)
+    stfd f20, 0x88(r3)
+    stfd f21, 0x90(r3)
+    stfd f22, 0x98(r3)
+    stfd f23, 0xA0(r3)
+    stfd f24, 0xA8(r3)
+    stfd f25, 0xB0(r3)
+    stfd f26, 0xB8(r3)
+    stfd f27, 0xC0(r3)
+    stfd f28, 0xC8(r3)
+    stfd f29, 0xD0(r3)
+    stfd f30, 0xD8(r3)
+    stfd f31, 0xE0(r3)
+
+    lfd f14, 0x58(r4)
+    lfd f15, 0x60(r4)
+    lfd f16, 0x68(r4)
+    lfd f17, 0x70(r4)
+    lfd f18, 0x78(r4)
+    lfd f19, 0x80(r4)
+    lfd f20, 0x88(r4)
+    lfd f21, 0x90(r4)
+    lfd f22, 0x98(r4)
+    lfd f23, 0xA0(r4)
+    lfd f24, 0xA8(r4)
+    lfd f25, 0xB0(r4)
+    lfd f26, 0xB8(r4)
+    lfd f27, 0xC0(r4)
+    lfd f28, 0xC8(r4)
+    lfd f29, 0xD0(r4)
+    lfd f30, 0xD8(r4)
+    lfd f31, 0xE0(r4)
+    lmw r14, 0x0C(r4)
+    lwz r0, 0x04(r4)
+    lwz r5, 0x08(r4)
+    lwz r1, 0x00(r4)
+    mtlr r0
+    mtcrf 0xFF, r5
+    blr
+    // clang-format on
+}
+
+#else
+
+static void fiber_switch( FiberContext *from, FiberContext *to )
+{
+    swapcontext( &from->uc, &to->uc );
+}
+
+#endif
+
+/* ================================ *
+ *     Scheduler
+ * ================================ */
+
+static Fiber *current( void )
+{
+    if( fiberCurrent == NULL )
+    {
+        fiberMain.state = FIBER_RUNNING;
+        fiberCurrent = &fiberMain;
+    }
+    return fiberCurrent;
+}
+
+static void ready_push( Fiber *fiber )
+{
+    fiber->state = FIBER_READY;
+    fiber->next = NULL;
+    if( readyTail )
+    {
+        readyTail->next = fiber;
+    }
+    else
+    {
+        readyHead = fiber;
+    }
+    readyTail = fiber;
+    readyCount++;
+}
+
+static Fiber *ready_pop( void )
+{
+    Fiber *fiber = readyHead;
+
+    if( fiber )
+    {
+        readyHead = fiber->next;
+        if( readyHead == NULL )
+        {
+            readyTail = NULL;
+        }
+        readyCount--;
+    }
+    return fiber;
+}
+
+// The caller has already queued or parked the current fiber
+static void resume( Fiber *next )
+{
+    Fiber *prev = fiberCurrent;
+
+    fiberCurrent = next;
+    next->state = FIBER_RUNNING;
+    next->switches++;
+    fiber_switch( &prev->context, &next->context );
+}
+
+// First code a new fiber runs, on its own stack
+static void fiber_entry( void )
+{
+    Fiber *self = fiberCurrent;
+    Fiber *joiner;
+    Fiber *next;
+
+    self->func( self->arg );
+
+    self->state = FIBER_DONE;
+    while( ( joiner = self->joiners ) != NULL )
+    {
+        self->joiners = joiner->next;
+        ready_push( joiner );
+    }
+
+    // Nothing ready means every other fiber is blocked in a join cycle
+    next = ready_pop( );
+    if( next == NULL )
+    {
+#ifdef __MWERKS__
+        PPCHalt( );
+#else
+        abort( );
+#endif
+    }
+    resume( next );
+}
+
+Fiber *fiber_create( FiberFunc func, void *arg, u32 stackSize )
+{
+    void *mark = arena_mark( );
+    Fiber *fiber;
+
+    if( stackSize < FIBER_MIN_STACK )
+    {
+        stackSize = FIBER_MIN_STACK;
+    }
+    stackSize = ( stackSize + FIBER_STACK_ALIGN - 1 ) & ~( FIBER_STACK_ALIGN - 1 );
+
+    fiber = (Fiber *)arena_alloc( sizeof( Fiber ), 8 );
+    if( fiber == NULL )
+    {
+        return NULL;
+    }
+    memset( fiber, 0, sizeof( Fiber ) );
+    fiber->stack = (u8 *)arena_alloc( stackSize, FIBER_STACK_ALIGN );
+    if( fiber->stack == NULL )
+    {
+        arena_release( mark );
+        return NULL;
+    }
+    fiber->stackSize = stackSize;
+    fiber->func = func;
+    fiber->arg = arg;
+
+#ifdef __MWERKS__
+    // An empty frame with a NULL back chain at the top of the stack, where
+    // fiber_entry's prologue stores LR at sp + 4
+    fiber->context.sp = (u32)( fiber->stack + stackSize - 16 );
+    *(u32 *)fiber->context.sp = 0;
+    fiber->context.lr = (u32)fiber_entry;
+#else
+    getcontext( &fiber->context.uc );
+    fiber->context.uc.uc_stack.ss_sp = fiber->stack;
+    fiber->context.uc.uc_stack.ss_size = stackSize;
+    fiber->context.uc.uc_link = NULL;
+    makecontext( &fiber->context.uc, fiber_entry, 0 );
+#endif
+
+    ready_push( fiber );
+    return fiber;
+}
+
+Fiber *fiber_current( void )
+{
+    return current( );
+}
+
+void fiber_yield( void )
+{
+    Fiber *self = current( );
+    Fiber *next = ready_pop( );
+
+    if( next )
+    {
+        ready_push( self );
+        resume( next );
+    }
+}
+
+BOOL fiber_join( Fiber *fiber )
+{
+    Fiber *self = current( );
+
+    if( fiber == self )
+    {
+        return FALSE;
+    }
+    while( fiber->state != FIBER_DONE )
+    {
+        if( readyHead == NULL )
+        {
+            return FALSE;
+        }
+        self->state = FIBER_BLOCKED;
+        self->next = fiber->joiners;
+        fiber->joiners = self;
+        resume( ready_pop( ) );
+    }
+    return TRUE;
+}
+
+u32 fiber_ready_count( void )
+{
+    return readyCount;
+}
@@ -0,0 +1,94 @@
+#ifndef RUNTIME_FIBER_H
+#define RUNTIME_FIBER_H
+
+#include <Common.h>
+
+#ifndef __MWERKS__
+#include <ucontext.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Fibers
+ * ================================ */
+
+// Cooperative fibers on one CPU: a fiber runs until it yields, joins an
+// unfinished fiber or returns. Code that called main() is the main fiber.
+//
+// A switch is an ordinary call as far as the compiler is concerned, so only
+// the state the ABI makes callee-saved is swapped: r1, r14-r31, f14-f31,
+// LR and CR. r2/r13 are the same small-data bases for every fiber. Paired
+// singles are off (HID2[PSE] is never set), so stfd covers the FPRs.
+//
+// Fibers and their stacks come from arena_alloc and are never freed
+// individually; take an arena_mark before creating them and release it once
+// they are joined. Native builds switch with ucontext instead.
+
+#define FIBER_MIN_STACK 0x400
+#define FIBER_STACK_ALIGN 32
+
+enum
+{
+    FIBER_READY,   // In the run queue
+    FIBER_RUNNING, // fiber_current()
+    FIBER_BLOCKED, // In fiber_join
+    FIBER_DONE
+};
+
+// Offsets are used by fiber_switch
+typedef struct FiberContext
+{
+#ifdef __MWERKS__
+    u32 sp;           // 0x00
+    u32 lr;           // 0x04
+    u32 cr;           // 0x08
+    u32 gpr[ 18 ];    // 0x0C r14-r31
+    u32 pad;          // 0x54
+    double fpr[ 18 ]; // 0x58 f14-f31
+#else
+    ucontext_t uc;
+#endif
+} FiberContext;
+
+typedef void ( *FiberFunc )( void *arg );
+
+typedef struct Fiber
+{
+    FiberContext context;
+    struct Fiber *next;    // Run queue or joiner list link
+    struct Fiber *joiners; // Blocked in fiber_join on this fiber
+    FiberFunc func;
+    void *arg;
+    u8 *stack; // Lowest address
+    u32 stackSize;
+    u32 state;
+    u32 switches; // Times this fiber was switched to
+} Fiber;
+
+// Allocates a fiber with `stackSize` bytes of stack (at least
+// FIBER_MIN_STACK) and queues it to run func(arg). Returns NULL when the
+// arena is out of space.
+Fiber *fiber_create( FiberFunc func, void *arg, u32 stackSize );
+
+Fiber *fiber_current( void );
+
+// Moves the current fiber to the back of the run queue and runs the front
+// one; returns immediately when nothing else is ready
+void fiber_yield( void );
+
+// Blocks until `fiber` has returned. Returns FALSE without blocking when no
+// other fiber could run, i.e. waiting would deadlock.
+BOOL fiber_join( Fiber *fiber );
+
+// Number of fibers in the run queue
+u32 fiber_ready_count( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+#include <runtime_core.h>
+#include <runtime_mem.h>
+
+MemStats __mem_stats;
+
+static u32 *stackLo;
+static u32 *stackHi;
+static u8 *arenaLo;
+static u8 *arenaHi;
+static u8 *arenaCur;
+
+/* ================================ *
+ *     Stack
+ * ================================ */
+
+void mem_init_stack( void *lo, void *hi, void *sp )
+{
+    u32 *p;
+    u32 *end = (u32 *)( ( (uintptr_t)sp - MEM_STACK_GUARD ) & ~3 );
+
+    stackLo = (u32 *)( ( (uintptr_t)lo + 3 ) & ~3 );
+    stackHi = (u32 *)hi;
+
+    for( p = stackLo; p < end; ++p )
+    {
+        *p = MEM_STACK_PAINT;
+    }
+
+    __mem_stats.magic = MEM_STATS_MAGIC;
+    __mem_stats.version = MEM_STATS_VERSION;
+    __mem_stats.stackSize = (u32)( (u8 *)stackHi - (u8 *)stackLo );
+    __mem_stats.stackHighWater = (u32)( (u8 *)stackHi - (u8 *)end );
+}
+
+u32 mem_stack_high_water( void )
+{
+    const u32 *p = stackLo;
+
+    while( p < stackHi && *p == MEM_STACK_PAINT )
+    {
+        ++p;
+    }
+
+    __mem_stats.stackHighWater = (u32)( (u8 *)stackHi - (u8 *)p );
+    return __mem_stats.stackHighWater;
+}
+
+/* ================================ *
+ *     Arena
+ * ================================ */
+
+static void arena_update( void )
+{
+    __mem_stats.arenaUsed = (u32)( arenaCur - arenaLo );
+    if( __mem_stats.arenaUsed > __mem_stats.arenaPeak )
+    {
+        __mem_stats.arenaPeak = __mem_stats.arenaUsed;
+    }
+}
+
+void mem_init_arena( void *lo, void *hi )
+{
+    arenaLo = (u8 *)lo;
+    arenaHi = (u8 *)hi;
+    arenaCur = arenaLo;
+
+    __mem_stats.arenaSize = (u32)( arenaHi - arenaLo );
+    __mem_stats.arenaUsed = 0;
+    __mem_stats.arenaPeak = 0;
+}
+
+void *arena_alloc( size_t size, size_t align )
+{
+    u8 *p = (u8 *)( ( (uintptr_t)arenaCur + align - 1 ) & ~( (uintptr_t)align - 1 ) );
+
+    if( p < arenaCur || (size_t)( arenaHi - p ) < size )
+    {
+        return NULL;
+    }
+
+    arenaCur = p + size;
+    arena_update( );
+    return p;
+}
+
+void *arena_mark( void )
+{
+    return arenaCur;
+}
+
+void arena_release( void *mark )
+{
+    if( (u8 *)mark >= arenaLo && (u8 *)mark <= arenaCur )
+    {
+        arenaCur = (u8 *)mark;
+        arena_update( );
+    }
+}
+
+/* ================================ *
+ *     Startup
+ * ================================ */
+
+#ifdef __MWERKS__
+
+asm static void *mem_get_sp( void )
+{
+    // clang-format off
+    nofralloc
+
+    mr r3, r1
+    blr
+    // clang-format on
+}
+
+__DECL_SECTION( ".init" ) void __init_mem( void )
+{
+    mem_init_stack( _stack_end, _stack_addr, mem_get_sp( ) );
+    mem_init_arena( __ArenaLo, __ArenaHi );
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef RUNTIME_MEM_H
+#define RUNTIME_MEM_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Memory telemetry
+ * ================================ */
+
+#define MEM_STATS_MAGIC 0x4D454D53 // 'MEMS'
+#define MEM_STATS_VERSION 1
+
+// Written over the unused stack at startup, the deepest overwritten word
+// gives the stack high-water mark
+#define MEM_STACK_PAINT 0xCDCDCDCD
+
+// Left unpainted below the stack pointer passed to mem_init_stack, room for
+// the frames of the painting code itself
+#define MEM_STACK_GUARD 0x100
+
+// Layout is read back from a memory dump by tools/mem_stats.py
+typedef struct MemStats
+{
+    u32 magic;
+    u32 version;
+    u32 stackSize;      // _stack_end to _stack_addr
+    u32 stackHighWater; // Deepest use seen by the last mem_stack_high_water()
+    u32 arenaSize;      // __ArenaLo to __ArenaHi
+    u32 arenaUsed;
+    u32 arenaPeak;
+} MemStats;
+
+extern MemStats __mem_stats;
+
+// Paints [lo, sp - MEM_STACK_GUARD) and records the stack bounds, `sp` is
+// the caller's stack pointer so nothing live is overwritten. __init_mem does
+// this with the real stack, the native tests with a buffer.
+void mem_init_stack( void *lo, void *hi, void *sp );
+void mem_init_arena( void *lo, void *hi );
+
+// Called from __start once .bss is cleared, before the constructors run
+void __init_mem( void );
+
+// Scans up from the stack end for the first overwritten word and returns the
+// deepest use in bytes, also stored in __mem_stats
+u32 mem_stack_high_water( void );
+
+/* ================================ *
+ *     Arena
+ * ================================ */
+
+// Bump allocator over the arena. Returns NULL when out of space; `align` must
+// be a power of two.
+void *arena_alloc( size_t size, size_t align );
+
+// Frees everything allocated after `mark`, a pointer from arena_alloc or
+// arena_mark
+void arena_release( void *mark );
+void *arena_mark( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,259 @@
+#include <runtime_core.h>
+
+/* ================================ *
+ *     Word-at-a-time string.h
+ * ================================ */
+
+// Once both pointers are word aligned these work on a u32 at a time. A word
+// holds a zero byte exactly when HAS_ZERO_BYTE is non-zero; the byte itself
+// is then found with a short byte loop, which also keeps the results
+// independent of endianness (native builds run little-endian).
+
+#define ONES 0x01010101u
+#define HIGHS 0x80808080u
+#define HAS_ZERO_BYTE( w ) ( ( ( w ) - ONES ) & ~( w ) & HIGHS )
+#define WORD_ALIGNED( p ) ( ( (uintptr_t)( p ) & 3 ) == 0 )
+
+// Words per unrolled block in memmove
+#define BLOCK_WORDS 8
+
+static void copy_forward( u8 *d, const u8 *s, size_t n )
+{
+    u32 *dw;
+    const u32 *sw;
+
+    if( ( ( (uintptr_t)d ^ (uintptr_t)s ) & 3 ) == 0 )
+    {
+        for( ; n && !WORD_ALIGNED( d ); --n )
+        {
+            *d++ = *s++;
+        }
+
+        dw = (u32 *)d;
+        sw = (const u32 *)s;
+        for( ; n >= BLOCK_WORDS * 4; n -= BLOCK_WORDS * 4 )
+        {
+            dw[ 0 ] = sw[ 0 ];
+            dw[ 1 ] = sw[ 1 ];
+            dw[ 2 ] = sw[ 2 ];
+            dw[ 3 ] = sw[ 3 ];
+            dw[ 4 ] = sw[ 4 ];
+            dw[ 5 ] = sw[ 5 ];
+            dw[ 6 ] = sw[ 6 ];
+            dw[ 7 ] = sw[ 7 ];
+            dw += BLOCK_WORDS;
+            sw += BLOCK_WORDS;
+        }
+        for( ; n >= 4; n -= 4 )
+        {
+            *dw++ = *sw++;
+        }
+        d = (u8 *)dw;
+        s = (const u8 *)sw;
+    }
+
+    for( ; n; --n )
+    {
+        *d++ = *s++;
+    }
+}
+
+// d and s point one past the end, overlapping copies with d > s must start
+// there so no source byte is overwritten before it is read
+static void copy_backward( u8 *d, const u8 *s, size_t n )
+{
+    u32 *dw;
+    const u32 *sw;
+
+    if( ( ( (uintptr_t)d ^ (uintptr_t)s ) & 3 ) == 0 )
+    {
+        for( ; n && !WORD_ALIGNED( d ); --n )
+        {
+            *--d = *--s;
+        }
+
+        dw = (u32 *)d;
+        sw = (const u32 *)s;
+        for( ; n >= BLOCK_WORDS * 4; n -= BLOCK_WORDS * 4 )
+        {
+            dw -= BLOCK_WORDS;
+            sw -= BLOCK_WORDS;
+            dw[ 7 ] = sw[ 7 ];
+            dw[ 6 ] = sw[ 6 ];
+            dw[ 5 ] = sw[ 5 ];
+            dw[ 4 ] = sw[ 4 ];
+            dw[ 3 ] = sw[ 3 ];
+            dw[ 2 ] = sw[ 2 ];
+            dw[ 1 ] = sw[ 1 ];
+            dw[ 0 ] = sw[ 0 ];
+        }
+        for( ; n >= 4; n -= 4 )
+        {
+            *--dw = *--sw;
+        }
+        d = (u8 *)dw;
+        s = (const u8 *)sw;
+    }
+
+    for( ; n; --n )
+    {
+        *--d = *--s;
+    }
+}
+
+void *memmove( void *dst, const void *src, size_t n )
+{
+    u8 *d = (u8 *)dst;
+    const u8 *s = (const u8 *)src;
+
+    if( d == s || n == 0 )
+    {
+        return dst;
+    }
+
+    // Unsigned distance, also true when d is below s
+    if( (uintptr_t)d - (uintptr_t)s >= n )
+    {
+        copy_forward( d, s, n );
+    }
+    else
+    {
+        copy_backward( d + n, s + n, n );
+    }
+
+    return dst;
+}
+
+int memcmp( const void *a, const void *b, size_t n )
+{
+    const u8 *p = (const u8 *)a;
+    const u8 *q = (const u8 *)b;
+
+    if( ( ( (uintptr_t)p ^ (uintptr_t)q ) & 3 ) == 0 )
+    {
+        for( ; n && !WORD_ALIGNED( p ); --n, ++p, ++q )
+        {
+            if( *p != *q )
+            {
+                return *p - *q;
+            }
+        }
+
+        // Skip equal words, the byte loop below orders the first difference
+        for( ; n >= 4 && *(const u32 *)p == *(const u32 *)q; n -= 4 )
+        {
+            p += 4;
+            q += 4;
+        }
+    }
+
+    for( ; n; --n, ++p, ++q )
+    {
+        if( *p != *q )
+        {
+            return *p - *q;
+        }
+    }
+
+    return 0;
+}
+
+void *memchr( const void *s, int c, size_t n )
+{
+    const u8 *p = (const u8 *)s;
+    u8 ch = (u8)c;
+    u32 pattern = (u32)ch * ONES;
+    u32 w;
+
+    for( ; n && !WORD_ALIGNED( p ); --n, ++p )
+    {
+        if( *p == ch )
+        {
+            return (void *)p;
+        }
+    }
+
+    // A word containing c has a zero byte after xoring with the pattern
+    for( ; n >= 4; n -= 4, p += 4 )
+    {
+        w = *(const u32 *)p ^ pattern;
+        if( HAS_ZERO_BYTE( w ) )
+        {
+            break;
+        }
+    }
+
+    for( ; n; --n, ++p )
+    {
+        if( *p == ch )
+        {
+            return (void *)p;
+        }
+    }
+
+    return NULL;
+}
+
+// Aligned word reads never cross into the next page, so reading past the
+// terminator within its word is safe
+size_t strlen( const char *s )
+{
+    const char *p = s;
+    u32 w;
+
+    for( ; !WORD_ALIGNED( p ); ++p )
+    {
+        if( *p == '\0' )
+        {
+            return p - s;
+        }
+    }
+
+    for( ;; p += 4 )
+    {
+        w = *(const u32 *)p;
+        if( HAS_ZERO_BYTE( w ) )
+        {
+            break;
+        }
+    }
+
+    while( *p )
+    {
+        ++p;
+    }
+    return p - s;
+}
+
+int strcmp( const char *a, const char *b )
+{
+    const u8 *p = (const u8 *)a;
+    const u8 *q = (const u8 *)b;
+    u32 w;
+
+    if( ( ( (uintptr_t)p ^ (uintptr_t)q ) & 3 ) == 0 )
+    {
+        for( ; !WORD_ALIGNED( p ); ++p, ++q )
+        {
+            if( *p != *q || *p == '\0' )
+            {
+                return *p - *q;
+            }
+        }
+
+        // Equal words without a terminator can be skipped whole
+        for( ;; p += 4, q += 4 )
+        {
+            w = *(const u32 *)p;
+            if( w != *(const u32 *)q || HAS_ZERO_BYTE( w ) )
+            {
+                break;
+            }
+        }
+    }
+
+    for( ; *p == *q && *p; ++p, ++q )
+    {
+    }
+    return *p - *q;
+}
@@ -0,0 +1,28 @@
+#include <runtime_time.h>
+
+#ifndef __MWERKS__
+#include <time.h>
+#endif
+
+/* ================================ *
+ *     OSTime.c
+ * ================================ */
+
+#ifdef __MWERKS__
+asm u32 runtime_ticks( void )
+{
+    // clang-format off
+    nofralloc
+
+    mftb r3
+    blr
+    // clang-format on
+}
+#else
+u32 runtime_ticks( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (u32)( ts.tv_sec * 1000000000ull + ts.tv_nsec );
+}
+#endif
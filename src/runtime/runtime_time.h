@@ -0,0 +1,24 @@
+#ifndef RUNTIME_TIME_H
+#define RUNTIME_TIME_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     OSTime.h
+ * ================================ */
+
+// Lower word of the time base (mftb), which on the GC ticks once per four bus
+// clocks; multiply by 12 for Gekko CPU cycles (486 MHz / 40.5 MHz). Native
+// builds count nanoseconds instead. Differences wrap after ~106 s.
+u32 runtime_ticks( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+#include <runtime_time.h>
+#include <trace.h>
+
+static_assert( ( TRACE_CAPACITY & ( TRACE_CAPACITY - 1 ) ) == 0 );
+
+TraceBuffer __trace_buffer;
+
+void trace_reset( void )
+{
+    __trace_buffer.magic = TRACE_MAGIC;
+    __trace_buffer.version = TRACE_VERSION;
+    __trace_buffer.capacity = TRACE_CAPACITY;
+    __trace_buffer.head = 0;
+    __trace_buffer.last = runtime_ticks( );
+}
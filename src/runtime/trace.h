@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Common.h>
+#include <runtime_time.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Event tracing
+ * ================================ */
+
+// TRACE_BEGIN/TRACE_END append an event to a ring buffer in .bss, the oldest
+// events are overwritten once it is full. Ids are any 32-bit value; function
+// addresses and string literals are resolved by tools/trace_decode.py:
+//
+//     TRACE_BEGIN( "physics" );
+//     ...
+//     TRACE_END( "physics" );
+
+#define TRACE_CAPACITY 1024 // Events, must be a power of two
+
+#define TRACE_MAGIC 0x54524345 // 'TRCE'
+#define TRACE_VERSION 1
+
+// Set in TraceEvent.delta for TRACE_END, the remaining bits are the time base
+// ticks since the previous event (up to ~53 s)
+#define TRACE_END_FLAG 0x80000000
+
+#define TRACE_BEGIN( id ) trace_record( (u32)(uintptr_t)( id ), 0 )
+#define TRACE_END( id ) trace_record( (u32)(uintptr_t)( id ), TRACE_END_FLAG )
+
+typedef struct TraceEvent
+{
+    u32 delta;
+    u32 id;
+} TraceEvent;
+
+// Layout is read back from a memory dump by tools/trace_decode.py
+typedef struct TraceBuffer
+{
+    u32 magic;
+    u32 version;
+    u32 capacity;
+    u32 head; // Total events recorded, the next slot is head % capacity
+    u32 last; // Time of the latest event
+    TraceEvent events[ TRACE_CAPACITY ];
+} TraceBuffer;
+
+extern TraceBuffer __trace_buffer;
+
+// Empties the buffer and writes its header
+void trace_reset( void );
+
+// Inlined into every TRACE_BEGIN/TRACE_END, so an event costs the time base
+// read and two stores instead of a call
+static inline void trace_record( u32 id, u32 flags )
+{
+    u32 now = runtime_ticks( );
+    TraceEvent *event = &__trace_buffer.events[ __trace_buffer.head++ & ( TRACE_CAPACITY - 1 ) ];
+
+    event->delta = ( ( now - __trace_buffer.last ) & ~TRACE_END_FLAG ) | flags;
+    event->id = id;
+    __trace_buffer.last = now;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
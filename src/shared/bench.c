@@ -0,0 +1,123 @@
+#include <runtime_time.h>
+#include <trace.h>
+
+#include "bench.h"
+
+typedef struct BenchCase
+{
+    const char *name;
+    BenchFunc func;
+    void *ctx;
+    u32 warmup;
+    u32 reps;
+} BenchCase;
+
+static BenchCase benchCases[ BENCH_MAX_CASES ];
+static int benchCaseCount;
+static u32 benchDropped;
+static u32 benchSamples[ BENCH_MAX_REPS ];
+
+BenchTable __bench_results;
+
+int bench_register( const char *name, BenchFunc func, void *ctx, u32 warmup, u32 reps )
+{
+    BenchCase *bc;
+
+    if( benchCaseCount >= BENCH_MAX_CASES )
+    {
+        ++benchDropped;
+        return -1;
+    }
+
+    if( reps == 0 )
+    {
+        reps = 1;
+    }
+    else if( reps > BENCH_MAX_REPS )
+    {
+        reps = BENCH_MAX_REPS;
+    }
+
+    bc = &benchCases[ benchCaseCount ];
+    bc->name = name;
+    bc->func = func;
+    bc->ctx = ctx;
+    bc->warmup = warmup;
+    bc->reps = reps;
+    return benchCaseCount++;
+}
+
+static void bench_empty( void *ctx ) {}
+
+// Runs one case and leaves its samples sorted in benchSamples
+static void bench_sample( BenchFunc func, void *ctx, u32 warmup, u32 reps )
+{
+    u32 i;
+    u32 j;
+    u32 start;
+    u32 t;
+
+    for( i = 0; i < warmup; ++i )
+    {
+        func( ctx );
+    }
+
+    for( i = 0; i < reps; ++i )
+    {
+        start = runtime_ticks( );
+        func( ctx );
+        t = runtime_ticks( ) - start;
+
+        // Insertion sort, reps is small
+        for( j = i; j > 0 && benchSamples[ j - 1 ] > t; --j )
+        {
+            benchSamples[ j ] = benchSamples[ j - 1 ];
+        }
+        benchSamples[ j ] = t;
+    }
+}
+
+void bench_run_all( void )
+{
+    int i;
+    u32 j;
+    u32 overhead;
+    BenchCase *bc;
+    BenchResult *res;
+
+    // Cost of the timing itself, subtracted from every sample
+    bench_sample( bench_empty, NULL, 4, BENCH_MAX_REPS );
+    overhead = benchSamples[ 0 ];
+
+    __bench_results.magic = BENCH_MAGIC;
+    __bench_results.version = BENCH_VERSION;
+    __bench_results.overhead = overhead;
+    __bench_results.dropped = benchDropped;
+    __bench_results.count = 0;
+
+    for( i = 0; i < benchCaseCount; ++i )
+    {
+        bc = &benchCases[ i ];
+        res = &__bench_results.results[ i ];
+
+        TRACE_BEGIN( bc->name );
+        bench_sample( bc->func, bc->ctx, bc->warmup, bc->reps );
+        TRACE_END( bc->name );
+        for( j = 0; j < bc->reps; ++j )
+        {
+            benchSamples[ j ] = benchSamples[ j ] > overhead ? benchSamples[ j ] - overhead : 0;
+        }
+
+        for( j = 0; j < BENCH_NAME_LEN - 1 && bc->name[ j ]; ++j )
+        {
+            res->name[ j ] = bc->name[ j ];
+        }
+        res->name[ j ] = '\0';
+        res->reps = bc->reps;
+        res->min = benchSamples[ 0 ];
+        res->median = benchSamples[ bc->reps / 2 ];
+        res->max = benchSamples[ bc->reps - 1 ];
+
+        __bench_results.count = i + 1;
+    }
+}
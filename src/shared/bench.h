@@ -0,0 +1,48 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Common.h>
+
+/* ================================ *
+ *     Microbenchmarks
+ * ================================ */
+
+// Cases are timed with runtime_ticks(), see runtime_time.h for the units.
+
+#define BENCH_MAX_CASES 64
+#define BENCH_MAX_REPS 64
+#define BENCH_NAME_LEN 24
+
+#define BENCH_MAGIC 0x424E4348 // 'BNCH'
+#define BENCH_VERSION 2
+
+typedef void ( *BenchFunc )( void *ctx );
+
+typedef struct BenchResult
+{
+    char name[ BENCH_NAME_LEN ];
+    u32 reps;
+    u32 min;
+    u32 median;
+    u32 max;
+} BenchResult;
+
+// Layout is read back from a memory dump by tools/bench_results.py
+typedef struct BenchTable
+{
+    u32 magic;
+    u32 version;
+    u32 count;
+    u32 overhead;
+    u32 dropped; // Cases bench_register refused because the table was full
+    BenchResult results[ BENCH_MAX_CASES ];
+} BenchTable;
+
+extern BenchTable __bench_results;
+
+// Returns the case index, or -1 when BENCH_MAX_CASES cases are registered
+// already; those are counted in __bench_results.dropped
+int bench_register( const char *name, BenchFunc func, void *ctx, u32 warmup, u32 reps );
+void bench_run_all( void );
+
+#endif
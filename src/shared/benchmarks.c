@@ -0,0 +1,267 @@
+// Cases for the benchmark DOL (`ninja bench`), add new ones to
+// run_benchmarks below
+
+#include <runtime_core.h>
+#include <runtime_fiber.h>
+
+#include "00_basic_assembly_and_isa.h"
+#include "01_abi_basics.h"
+#include "bench.h"
+#include "benchmarks.h"
+#include "fastmath.h"
+
+static u8 benchBuffer[ 2 ][ 0x400 ];
+static char benchString[ 2 ][ 0x400 ];
+static double benchDoubles[ 3 ];
+static volatile size_t benchSink; // Keeps the static baselines from being optimized out
+static float benchFloats[ 64 ];
+static Vec3 benchVecs[ 64 ];
+static volatile float benchFloatSink;
+
+static void bench_addition( void *ctx )
+{
+    addition( 1, 2 );
+}
+
+static void bench_addition_double_load_store( void *ctx )
+{
+    addition_double_load_store( &benchDoubles[ 0 ], &benchDoubles[ 1 ], &benchDoubles[ 2 ] );
+}
+
+static void bench_call_weird_func( void *ctx )
+{
+    int b;
+    call_weird_func( 2, &b );
+}
+
+static void bench_memset( void *ctx )
+{
+    memset( benchBuffer[ 0 ], 0, sizeof( benchBuffer[ 0 ] ) );
+}
+
+static void bench_memcpy( void *ctx )
+{
+    memcpy( benchBuffer[ 1 ], benchBuffer[ 0 ], sizeof( benchBuffer[ 0 ] ) );
+}
+
+// Byte-at-a-time baselines for the word-at-a-time versions in runtime_string.c
+
+static void naive_memmove( u8 *d, const u8 *s, size_t n )
+{
+    if( d < s )
+    {
+        for( ; n; --n )
+        {
+            *d++ = *s++;
+        }
+    }
+    else
+    {
+        for( d += n, s += n; n; --n )
+        {
+            *--d = *--s;
+        }
+    }
+}
+
+static int naive_memcmp( const u8 *a, const u8 *b, size_t n )
+{
+    for( ; n; --n, ++a, ++b )
+    {
+        if( *a != *b )
+        {
+            return *a - *b;
+        }
+    }
+    return 0;
+}
+
+static const u8 *naive_memchr( const u8 *s, u8 c, size_t n )
+{
+    for( ; n; --n, ++s )
+    {
+        if( *s == c )
+        {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static size_t naive_strlen( const char *s )
+{
+    const char *p = s;
+    while( *p )
+    {
+        ++p;
+    }
+    return p - s;
+}
+
+static int naive_strcmp( const u8 *a, const u8 *b )
+{
+    for( ; *a == *b && *a; ++a, ++b )
+    {
+    }
+    return *a - *b;
+}
+
+// Overlapping by 4 bytes so the backward path is measured
+static void bench_memmove( void *ctx )
+{
+    memmove( benchBuffer[ 0 ] + 4, benchBuffer[ 0 ], sizeof( benchBuffer[ 0 ] ) - 4 );
+}
+
+static void bench_naive_memmove( void *ctx )
+{
+    naive_memmove( benchBuffer[ 0 ] + 4, benchBuffer[ 0 ], sizeof( benchBuffer[ 0 ] ) - 4 );
+}
+
+static void bench_memcmp( void *ctx )
+{
+    benchSink = (size_t)memcmp( benchBuffer[ 0 ], benchBuffer[ 1 ], sizeof( benchBuffer[ 0 ] ) );
+}
+
+static void bench_naive_memcmp( void *ctx )
+{
+    benchSink = (size_t)naive_memcmp( benchBuffer[ 0 ], benchBuffer[ 1 ], sizeof( benchBuffer[ 0 ] ) );
+}
+
+static void bench_memchr( void *ctx )
+{
+    benchSink = (size_t)memchr( benchBuffer[ 0 ], 0xFF, sizeof( benchBuffer[ 0 ] ) );
+}
+
+static void bench_naive_memchr( void *ctx )
+{
+    benchSink = (size_t)naive_memchr( benchBuffer[ 0 ], 0xFF, sizeof( benchBuffer[ 0 ] ) );
+}
+
+static void bench_strlen( void *ctx )
+{
+    benchSink = (size_t)strlen( benchString[ 0 ] );
+}
+
+static void bench_naive_strlen( void *ctx )
+{
+    benchSink = (size_t)naive_strlen( benchString[ 0 ] );
+}
+
+static void bench_strcmp( void *ctx )
+{
+    benchSink = (size_t)strcmp( benchString[ 0 ], benchString[ 1 ] );
+}
+
+static void bench_naive_strcmp( void *ctx )
+{
+    benchSink = (size_t)naive_strcmp( (const u8 *)benchString[ 0 ], (const u8 *)benchString[ 1 ] );
+}
+
+// Fast math cases each run over benchFloats, divide by 64 for a single call
+#define BENCH_FLOATS( name, expr )                                                                 \
+    static void bench_##name( void *ctx )                                                          \
+    {                                                                                              \
+        float sum = 0.0f;                                                                          \
+        int i;                                                                                     \
+        for ( i = 0; i < 64; i++ )                                                                 \
+        {                                                                                          \
+            float x = benchFloats[ i ];                                                            \
+            sum += expr;                                                                           \
+        }                                                                                          \
+        benchFloatSink = sum;                                                                      \
+    }
+
+BENCH_FLOATS( rsqrt_lo, fast_rsqrt_lo( x ) )
+BENCH_FLOATS( rsqrt_hi, fast_rsqrt_hi( x ) )
+BENCH_FLOATS( recip_lo, fast_recip_lo( x ) )
+BENCH_FLOATS( recip_hi, fast_recip_hi( x ) )
+BENCH_FLOATS( sin_lo, fast_sin_lo( x ) )
+BENCH_FLOATS( sin_hi, fast_sin_hi( x ) )
+BENCH_FLOATS( atan2_lo, fast_atan2_lo( x, 1.5f - x ) )
+BENCH_FLOATS( atan2_hi, fast_atan2_hi( x, 1.5f - x ) )
+
+static void bench_vec3_normalize( void *ctx )
+{
+    float sum = 0.0f;
+    int i;
+    for ( i = 0; i < 64; i++ )
+    {
+        Vec3 out;
+        sum += vec3_normalize( &out, &benchVecs[ i ] );
+    }
+    benchFloatSink = sum;
+}
+
+// Yields straight back to whoever yielded to it
+static void bench_fiber_partner( void *arg )
+{
+    for( ;; )
+    {
+        fiber_yield( );
+    }
+}
+
+// 32 round trips through the partner, 64 switches
+static void bench_fiber_switch( void *ctx )
+{
+    int i;
+    for( i = 0; i < 32; i++ )
+    {
+        fiber_yield( );
+    }
+}
+
+void run_benchmarks( void )
+{
+    int i;
+
+    bench_register( "addition", bench_addition, NULL, 4, 32 );
+    bench_register( "addition_double_ls", bench_addition_double_load_store, NULL, 4, 32 );
+    bench_register( "call_weird_func", bench_call_weird_func, NULL, 4, 32 );
+    bench_register( "memset_1k", bench_memset, NULL, 2, 16 );
+    bench_register( "memcpy_1k", bench_memcpy, NULL, 2, 16 );
+
+    // Equal 1k buffers/strings, so every function scans to the end
+    memset( benchBuffer[ 0 ], 0, sizeof( benchBuffer[ 0 ] ) );
+    memset( benchBuffer[ 1 ], 0, sizeof( benchBuffer[ 1 ] ) );
+    memset( benchString[ 0 ], 'a', sizeof( benchString[ 0 ] ) - 1 );
+    memset( benchString[ 1 ], 'a', sizeof( benchString[ 1 ] ) - 1 );
+    bench_register( "memmove_1k", bench_memmove, NULL, 2, 16 );
+    bench_register( "naive_memmove_1k", bench_naive_memmove, NULL, 2, 16 );
+    bench_register( "memcmp_1k", bench_memcmp, NULL, 2, 16 );
+    bench_register( "naive_memcmp_1k", bench_naive_memcmp, NULL, 2, 16 );
+    bench_register( "memchr_1k", bench_memchr, NULL, 2, 16 );
+    bench_register( "naive_memchr_1k", bench_naive_memchr, NULL, 2, 16 );
+    bench_register( "strlen_1k", bench_strlen, NULL, 2, 16 );
+    bench_register( "naive_strlen_1k", bench_naive_strlen, NULL, 2, 16 );
+    bench_register( "strcmp_1k", bench_strcmp, NULL, 2, 16 );
+    bench_register( "naive_strcmp_1k", bench_naive_strcmp, NULL, 2, 16 );
+
+    // Positive inputs spread over (0, 4], so every function sees several octants/table entries
+    for ( i = 0; i < 64; i++ )
+    {
+        benchFloats[ i ] = ( i + 1 ) * ( 4.0f / 64 );
+        benchVecs[ i ].x = benchFloats[ i ];
+        benchVecs[ i ].y = 1.0f - benchFloats[ i ];
+        benchVecs[ i ].z = 0.5f;
+    }
+    bench_register( "rsqrt_lo_x64", bench_rsqrt_lo, NULL, 2, 16 );
+    bench_register( "rsqrt_hi_x64", bench_rsqrt_hi, NULL, 2, 16 );
+    bench_register( "recip_lo_x64", bench_recip_lo, NULL, 2, 16 );
+    bench_register( "recip_hi_x64", bench_recip_hi, NULL, 2, 16 );
+    bench_register( "sin_lo_x64", bench_sin_lo, NULL, 2, 16 );
+    bench_register( "sin_hi_x64", bench_sin_hi, NULL, 2, 16 );
+    bench_register( "atan2_lo_x64", bench_atan2_lo, NULL, 2, 16 );
+    bench_register( "atan2_hi_x64", bench_atan2_hi, NULL, 2, 16 );
+    bench_register( "vec3_normalize_x64", bench_vec3_normalize, NULL, 2, 16 );
+
+    register_container_benchmarks( );
+
+    // The partner never finishes, it lives in the arena for the rest of the run
+    if( fiber_create( bench_fiber_partner, NULL, FIBER_MIN_STACK ) )
+    {
+        bench_register( "fiber_switch_x64", bench_fiber_switch, NULL, 2, 16 );
+    }
+
+    bench_run_all( );
+}
@@ -0,0 +1,9 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+void run_benchmarks( void );
+
+// container_benchmarks.cpp
+void register_container_benchmarks( void );
+
+#endif
@@ -0,0 +1,71 @@
+#include <runtime_core.h>
+#include <runtime_mem.h>
+
+#include "blob.h"
+
+static_assert( sizeof( BlobHeader ) == 32 + sizeof( uintptr_t ) );
+
+u32 blob_size( const void *blob )
+{
+    const BlobHeader *header = (const BlobHeader *)blob;
+
+    if( header->magic != BLOB_MAGIC || header->version != BLOB_VERSION || header->pointerSize != sizeof( void * ) )
+    {
+        return 0;
+    }
+    return header->size;
+}
+
+void *blob_load( const void *blob )
+{
+    BlobHeader *header = (BlobHeader *)blob;
+    u8 *base = (u8 *)blob;
+    uintptr_t delta = (uintptr_t)base - header->base;
+    const u32 *fixup;
+    const u32 *end;
+    uintptr_t *p;
+
+    if( blob_size( blob ) == 0 )
+    {
+        return NULL;
+    }
+
+    // NULL pointers aren't in the table, so moving twice still works
+    if( delta != 0 )
+    {
+        fixup = (const u32 *)( base + header->fixupOffset );
+        end = fixup + header->fixupCount;
+        for( ; fixup < end; ++fixup )
+        {
+            p = (uintptr_t *)( base + *fixup );
+            *p += delta;
+        }
+        header->base = (uintptr_t)base;
+    }
+    return base + header->root;
+}
+
+void *blob_load_copy( void *dst, const void *src )
+{
+    u32 size = blob_size( src );
+
+    if( size == 0 )
+    {
+        return NULL;
+    }
+    memcpy( dst, src, size );
+    return blob_load( dst );
+}
+
+void *blob_load_arena( const void *src )
+{
+    u32 size = blob_size( src );
+    void *dst;
+
+    if( size == 0 )
+    {
+        return NULL;
+    }
+    dst = arena_alloc( size, 8 );
+    return dst ? blob_load_copy( dst, src ) : NULL;
+}
@@ -0,0 +1,75 @@
+#ifndef BLOB_H
+#define BLOB_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Relocatable blobs
+ * ================================ */
+
+// Data packed by tools/blob_pack.py is used where it lies: pointers inside
+// the blob are stored as offsets from its start (0 for NULL) and the fixup
+// table lists where they are, so loading adds the blob's address to each of
+// them and nothing else. Load time depends on the number of pointers, not
+// the size of the data.
+//
+// A blob can be
+//   - embedded with `blob_pack.py --c name`, which defines BLOB_DATA
+//     `u64 name[]` (.rodata on the target, which has no write protection,
+//     so it's fixed up where the DOL loader put it), then blob_load( name )
+//   - copied out of a staging buffer with blob_load_copy, or into the arena
+//     with blob_load_arena, the same memcpy the startup code uses for
+//     _rom_copy_info sections
+// Only use the data through the pointer blob_load returns.
+//
+// The header records the address the pointers were last fixed up for, so a
+// loaded blob can be moved and loaded again, and loading twice is free.
+
+#define BLOB_MAGIC 0x424C4F42 // 'BLOB'
+#define BLOB_VERSION 1
+
+#ifdef __MWERKS__
+#define BLOB_DATA const
+#else
+// Host .rodata is read-only
+#define BLOB_DATA
+#endif
+
+// Layout is written by tools/blob_pack.py, in the target's byte order and
+// pointer size (the host's for --native)
+typedef struct BlobHeader
+{
+    u32 magic;
+    u32 version;
+    u32 pointerSize;
+    u32 size;        // Including header and fixups, a multiple of 8
+    u32 root;        // Offset of the root object
+    u32 fixupOffset; // Sorted u32 offsets of every non-NULL pointer
+    u32 fixupCount;
+    u32 pad;
+    uintptr_t base; // Address the pointers are relative to, 0 when packed
+} BlobHeader;
+
+// Fixes the blob up for its current address and returns its root object,
+// or NULL if it isn't a blob for this target
+void *blob_load( const void *blob );
+
+// Copies the blob to `dst` (blob_size bytes, 8-byte aligned) and loads it
+void *blob_load_copy( void *dst, const void *src );
+
+// Copies the blob into the arena and loads it, NULL when it doesn't fit
+void *blob_load_arena( const void *src );
+
+// 0 if it isn't a blob for this target
+u32 blob_size( const void *blob );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
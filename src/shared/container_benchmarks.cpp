@@ -0,0 +1,126 @@
+// Container cases for the benchmark DOL, registered from run_benchmarks
+
+#include <containers.h>
+
+extern "C"
+{
+  #include "bench.h"
+  #include "benchmarks.h"
+}
+
+#define CONTAINER_BENCH_ITEMS 64
+
+struct Particle
+{
+    float x, y, z;
+    u32 id;
+};
+
+struct Node : IntrusiveLink<Node>
+{
+    u32 id;
+};
+
+static FixedVector<Particle, CONTAINER_BENCH_ITEMS> benchVector;
+static FixedHashMap<u32, u32, CONTAINER_BENCH_ITEMS * 2> benchMap;
+static u32 benchLinearKeys[ CONTAINER_BENCH_ITEMS ];
+static Node benchNodes[ CONTAINER_BENCH_ITEMS ];
+static IntrusiveList<Node> benchList;
+static Pool<Particle, CONTAINER_BENCH_ITEMS> benchPool;
+static volatile u32 benchContainerSink;
+
+// Spread out like addresses or ids, not consecutive
+static u32 bench_key( u32 i )
+{
+    return i * 0x9E3779B1;
+}
+
+static void bench_vector_fill( void *ctx )
+{
+    benchVector.clear( );
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        Particle *p = benchVector.alloc_back( );
+        p->id = i;
+    }
+    benchContainerSink = benchVector.size( );
+}
+
+static void bench_hashmap_insert( void *ctx )
+{
+    benchMap.clear( );
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        benchMap.insert( bench_key( i ), i );
+    }
+    benchContainerSink = benchMap.size( );
+}
+
+static void bench_hashmap_find( void *ctx )
+{
+    u32 sum = 0;
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        sum += *benchMap.find( bench_key( i ) );
+    }
+    benchContainerSink = sum;
+}
+
+// Baseline for hashmap_find: scanning an unsorted key array
+static void bench_linear_find( void *ctx )
+{
+    u32 sum = 0;
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        u32 key = bench_key( i );
+        u32 j = 0;
+        while( benchLinearKeys[ j ] != key )
+        {
+            j++;
+        }
+        sum += j;
+    }
+    benchContainerSink = sum;
+}
+
+// Moves every node from the front to the back once
+static void bench_list_rotate( void *ctx )
+{
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        benchList.push_back( benchList.pop_front( ) );
+    }
+    benchContainerSink = benchList.front( )->id;
+}
+
+static void bench_pool_churn( void *ctx )
+{
+    Particle *live[ CONTAINER_BENCH_ITEMS ];
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        live[ i ] = benchPool.alloc( );
+    }
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        benchPool.free( live[ i ] );
+    }
+    benchContainerSink = benchPool.size( );
+}
+
+extern "C" void register_container_benchmarks( void )
+{
+    for( u32 i = 0; i < CONTAINER_BENCH_ITEMS; i++ )
+    {
+        benchLinearKeys[ i ] = bench_key( i );
+        benchMap.insert( bench_key( i ), i );
+        benchNodes[ i ].id = i;
+        benchList.push_back( &benchNodes[ i ] );
+    }
+
+    bench_register( "vector_fill_64", bench_vector_fill, NULL, 2, 16 );
+    bench_register( "hashmap_insert_64", bench_hashmap_insert, NULL, 2, 16 );
+    bench_register( "hashmap_find_64", bench_hashmap_find, NULL, 2, 16 );
+    bench_register( "linear_find_64", bench_linear_find, NULL, 2, 16 );
+    bench_register( "list_rotate_64", bench_list_rotate, NULL, 2, 16 );
+    bench_register( "pool_churn_64", bench_pool_churn, NULL, 2, 16 );
+}
@@ -0,0 +1,494 @@
+#ifndef CONTAINERS_H
+#define CONTAINERS_H
+
+#include <Common.h>
+
+#ifndef __cplusplus
+#error containers.h is C++ only
+#endif
+
+// Fixed-capacity containers that never touch the heap (`operator new`
+// returns NULL in main.cpp). Storage lives inside the container, so a
+// container placed in .bss or on the stack is all the memory it will ever
+// use, and operations that would grow past the capacity return NULL/FALSE
+// instead. Elements are constructed in place and destroyed on removal.
+//
+// Only C++98 is used so the pinned mwcc versions (-Cpp_exceptions off)
+// accept it as well as the host compiler. Containers can't be copied.
+
+#ifdef __MWERKS__
+// -nosyspath, no <new>
+inline void *operator new( size_t, void *where )
+{
+    return where;
+}
+#else
+#include <new>
+#endif
+
+/* ================================ *
+ *     Storage
+ * ================================ */
+
+// Uninitialized room for N objects of type T, aligned for any scalar
+template <typename T, u32 N>
+union FixedStorage
+{
+    u8 bytes[ sizeof( T ) * N ];
+    u64 alignU64;
+    double alignDouble;
+    void *alignPtr;
+};
+
+/* ================================ *
+ *     FixedVector
+ * ================================ */
+
+template <typename T, u32 N>
+class FixedVector
+{
+public:
+    FixedVector( ) : count( 0 ) {}
+    ~FixedVector( ) { clear( ); }
+
+    u32 size( ) const { return count; }
+    u32 capacity( ) const { return N; }
+    BOOL empty( ) const { return count == 0; }
+    BOOL full( ) const { return count == N; }
+
+    T *data( ) { return (T *)storage.bytes; }
+    const T *data( ) const { return (const T *)storage.bytes; }
+    T *begin( ) { return data( ); }
+    T *end( ) { return data( ) + count; }
+    const T *begin( ) const { return data( ); }
+    const T *end( ) const { return data( ) + count; }
+
+    T &operator[]( u32 i ) { return data( )[ i ]; }
+    const T &operator[]( u32 i ) const { return data( )[ i ]; }
+    T &front( ) { return data( )[ 0 ]; }
+    T &back( ) { return data( )[ count - 1 ]; }
+
+    // Returns the new element, or NULL when full
+    T *push_back( const T &value )
+    {
+        if( count == N )
+        {
+            return NULL;
+        }
+        return new( data( ) + count++ ) T( value );
+    }
+
+    // Default-constructs the new element, for filling large ones in place
+    T *alloc_back( )
+    {
+        if( count == N )
+        {
+            return NULL;
+        }
+        return new( data( ) + count++ ) T( );
+    }
+
+    void pop_back( ) { data( )[ --count ].~T( ); }
+
+    // Keeps the order, O(n)
+    void erase( u32 i )
+    {
+        T *items = data( );
+        for( --count; i < count; i++ )
+        {
+            items[ i ] = items[ i + 1 ];
+        }
+        items[ count ].~T( );
+    }
+
+    // Moves the last element into the hole, O(1)
+    void erase_unordered( u32 i )
+    {
+        T *items = data( );
+        if( i != --count )
+        {
+            items[ i ] = items[ count ];
+        }
+        items[ count ].~T( );
+    }
+
+    void clear( )
+    {
+        while( count )
+        {
+            pop_back( );
+        }
+    }
+
+private:
+    FixedVector( const FixedVector & );
+    FixedVector &operator=( const FixedVector & );
+
+    FixedStorage<T, N> storage;
+    u32 count;
+};
+
+/* ================================ *
+ *     FixedHashMap
+ * ================================ */
+
+// Hashes for FixedHashMap keys. Other key types need a container_hash
+// overload next to their declaration (found by argument-dependent lookup)
+// and operator==.
+inline u32 container_hash( unsigned long key )
+{
+    // Bit mixer from "lowbias32", every input bit affects the low bits used
+    // for the slot index
+    u32 h = (u32)key;
+    h ^= h >> 16;
+    h *= 0x7FEB352D;
+    h ^= h >> 15;
+    h *= 0x846CA68B;
+    h ^= h >> 16;
+    return h;
+}
+
+inline u32 container_hash( long key ) { return container_hash( (unsigned long)key ); }
+inline u32 container_hash( unsigned int key ) { return container_hash( (unsigned long)key ); }
+inline u32 container_hash( int key ) { return container_hash( (unsigned long)key ); }
+inline u32 container_hash( u64 key ) { return container_hash( (unsigned long)( key ^ ( key >> 32 ) ) ); }
+inline u32 container_hash( s64 key ) { return container_hash( (u64)key ); }
+
+template <typename P>
+inline u32 container_hash( P *key )
+{
+    return container_hash( (unsigned long)(uintptr_t)key );
+}
+
+// Open addressing with linear probing over a power-of-two number of slots.
+// Keys live in their own array so probing only touches keys and the used
+// flags; erase shifts the following entries back instead of leaving
+// tombstones, so probe lengths never degrade. Probing is bounded by N, so
+// the map can be filled completely, but keep it under ~75% for short probes.
+template <typename K, typename V, u32 N>
+class FixedHashMap
+{
+public:
+    enum
+    {
+        MASK = N - 1
+    };
+
+    FixedHashMap( ) : count( 0 )
+    {
+        static_assert( N != 0 && ( N & ( N - 1 ) ) == 0 );
+        for( u32 i = 0; i < N; i++ )
+        {
+            used[ i ] = FALSE;
+        }
+    }
+    ~FixedHashMap( ) { clear( ); }
+
+    u32 size( ) const { return count; }
+    u32 capacity( ) const { return N; }
+    BOOL empty( ) const { return count == 0; }
+
+    V *find( const K &key )
+    {
+        u32 slot = find_slot( key );
+        return slot == N ? NULL : &values( )[ slot ];
+    }
+
+    // Inserts or overwrites, returns the stored value or NULL when full
+    V *insert( const K &key, const V &value )
+    {
+        u32 slot = home( key );
+        for( u32 probes = 0; probes < N; probes++, slot = ( slot + 1 ) & MASK )
+        {
+            if( !used[ slot ] )
+            {
+                new( &keys( )[ slot ] ) K( key );
+                used[ slot ] = TRUE;
+                count++;
+                return new( &values( )[ slot ] ) V( value );
+            }
+            if( keys( )[ slot ] == key )
+            {
+                values( )[ slot ] = value;
+                return &values( )[ slot ];
+            }
+        }
+        return NULL;
+    }
+
+    BOOL erase( const K &key )
+    {
+        u32 hole = find_slot( key );
+        if( hole == N )
+        {
+            return FALSE;
+        }
+        destroy( hole );
+        count--;
+
+        // Pull back every following entry of the cluster that may live in
+        // the hole, i.e. whose home is not between the hole and itself
+        for( u32 slot = ( hole + 1 ) & MASK; used[ slot ]; slot = ( slot + 1 ) & MASK )
+        {
+            u32 fromHome = ( slot - home( keys( )[ slot ] ) ) & MASK;
+            if( fromHome >= ( ( slot - hole ) & MASK ) )
+            {
+                new( &keys( )[ hole ] ) K( keys( )[ slot ] );
+                new( &values( )[ hole ] ) V( values( )[ slot ] );
+                used[ hole ] = TRUE;
+                destroy( slot );
+                hole = slot;
+            }
+        }
+        return TRUE;
+    }
+
+    void clear( )
+    {
+        for( u32 i = 0; i < N; i++ )
+        {
+            if( used[ i ] )
+            {
+                destroy( i );
+            }
+        }
+        count = 0;
+    }
+
+    // Slot iteration: for( s = map.first( ); s != map.end( ); s = map.next( s ) )
+    u32 first( ) const { return next_used( 0 ); }
+    u32 next( u32 slot ) const { return next_used( slot + 1 ); }
+    u32 end( ) const { return N; }
+    const K &key_at( u32 slot ) const { return keys( )[ slot ]; }
+    V &value_at( u32 slot ) { return values( )[ slot ]; }
+
+private:
+    FixedHashMap( const FixedHashMap & );
+    FixedHashMap &operator=( const FixedHashMap & );
+
+    K *keys( ) { return (K *)keyStorage.bytes; }
+    const K *keys( ) const { return (const K *)keyStorage.bytes; }
+    V *values( ) { return (V *)valueStorage.bytes; }
+
+    static u32 home( const K &key ) { return container_hash( key ) & MASK; }
+
+    u32 find_slot( const K &key ) const
+    {
+        u32 slot = home( key );
+        for( u32 probes = 0; probes < N && used[ slot ]; probes++, slot = ( slot + 1 ) & MASK )
+        {
+            if( keys( )[ slot ] == key )
+            {
+                return slot;
+            }
+        }
+        return N;
+    }
+
+    u32 next_used( u32 slot ) const
+    {
+        while( slot < N && !used[ slot ] )
+        {
+            slot++;
+        }
+        return slot;
+    }
+
+    void destroy( u32 slot )
+    {
+        keys( )[ slot ].~K( );
+        values( )[ slot ].~V( );
+        used[ slot ] = FALSE;
+    }
+
+    FixedStorage<K, N> keyStorage;
+    FixedStorage<V, N> valueStorage;
+    u8 used[ N ];
+    u32 count;
+};
+
+/* ================================ *
+ *     IntrusiveList
+ * ================================ */
+
+// Doubly linked list threaded through the items themselves. An item joins
+// one list per IntrusiveLink base; the Tag tells them apart, e.g.
+//   struct Task : IntrusiveLink<Task>, IntrusiveLink<ReadyTag> { ... };
+//   IntrusiveList<Task> all;
+//   IntrusiveList<Task, ReadyTag> ready;
+// The list doesn't own its items, it only unlinks them when cleared.
+template <typename Tag>
+struct IntrusiveLink
+{
+    IntrusiveLink( ) : prev( NULL ), next( NULL ) {}
+
+    BOOL linked( ) const { return next != NULL; }
+
+    IntrusiveLink *prev;
+    IntrusiveLink *next;
+};
+
+template <typename T, typename Tag = T>
+class IntrusiveList
+{
+public:
+    typedef IntrusiveLink<Tag> Link;
+
+    IntrusiveList( ) : count( 0 ) { head.prev = head.next = &head; }
+    ~IntrusiveList( ) { clear( ); }
+
+    u32 size( ) const { return count; }
+    BOOL empty( ) const { return count == 0; }
+
+    // NULL when empty or at the end
+    T *front( ) { return item_or_null( head.next ); }
+    T *back( ) { return item_or_null( head.prev ); }
+    T *next( T *item ) { return item_or_null( link( item )->next ); }
+    T *prev( T *item ) { return item_or_null( link( item )->prev ); }
+
+    void push_front( T *item ) { link_after( &head, link( item ) ); }
+    void push_back( T *item ) { link_after( head.prev, link( item ) ); }
+    void insert_before( T *pos, T *item ) { link_after( link( pos )->prev, link( item ) ); }
+    void insert_after( T *pos, T *item ) { link_after( link( pos ), link( item ) ); }
+
+    T *pop_front( )
+    {
+        T *item = front( );
+        if( item )
+        {
+            remove( item );
+        }
+        return item;
+    }
+
+    T *pop_back( )
+    {
+        T *item = back( );
+        if( item )
+        {
+            remove( item );
+        }
+        return item;
+    }
+
+    void remove( T *item )
+    {
+        Link *l = link( item );
+        l->prev->next = l->next;
+        l->next->prev = l->prev;
+        l->prev = l->next = NULL;
+        count--;
+    }
+
+    void clear( )
+    {
+        while( pop_front( ) )
+        {
+        }
+    }
+
+private:
+    IntrusiveList( const IntrusiveList & );
+    IntrusiveList &operator=( const IntrusiveList & );
+
+    static Link *link( T *item ) { return static_cast<Link *>( item ); }
+    T *item_or_null( Link *l ) { return l == &head ? NULL : static_cast<T *>( l ); }
+
+    void link_after( Link *pos, Link *l )
+    {
+        l->prev = pos;
+        l->next = pos->next;
+        pos->next->prev = l;
+        pos->next = l;
+        count++;
+    }
+
+    Link head;
+    u32 count;
+};
+
+/* ================================ *
+ *     Pool
+ * ================================ */
+
+// N slots of T; free slots hold the free list in their own storage.
+// Slots past the high-water mark are handed out in order before the free
+// list grows, so a fresh pool needs no setup pass. Objects still allocated
+// when the pool goes away are not destroyed.
+template <typename T, u32 N>
+class Pool
+{
+public:
+    Pool( ) : freeList( NULL ), highWater( 0 ), live( 0 ) {}
+
+    u32 size( ) const { return live; }
+    u32 capacity( ) const { return N; }
+    BOOL full( ) const { return live == N; }
+
+    // Default-constructed object, or NULL when every slot is in use
+    T *alloc( )
+    {
+        void *slot = take( );
+        return slot ? new( slot ) T( ) : NULL;
+    }
+
+    T *alloc( const T &init )
+    {
+        void *slot = take( );
+        return slot ? new( slot ) T( init ) : NULL;
+    }
+
+    void free( T *object )
+    {
+        object->~T( );
+        Slot *slot = (Slot *)object;
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    BOOL owns( const T *object ) const
+    {
+        const u8 *p = (const u8 *)object;
+        return p >= (const u8 *)slots && p < (const u8 *)( slots + N );
+    }
+
+private:
+    Pool( const Pool & );
+    Pool &operator=( const Pool & );
+
+    union Slot
+    {
+        Slot *next;
+        u8 bytes[ sizeof( T ) ];
+        u64 alignU64;
+        double alignDouble;
+    };
+
+    void *take( )
+    {
+        Slot *slot;
+        if( freeList )
+        {
+            slot = freeList;
+            freeList = slot->next;
+        }
+        else if( highWater < N )
+        {
+            slot = &slots[ highWater++ ];
+        }
+        else
+        {
+            return NULL;
+        }
+        live++;
+        return slot;
+    }
+
+    Slot slots[ N ];
+    Slot *freeList;
+    u32 highWater;
+    u32 live;
+};
+
+#endif
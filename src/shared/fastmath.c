@@ -0,0 +1,325 @@
+#include "fastmath.h"
+
+// Never compiled with -profile, these are meant to be called in inner loops
+
+#ifdef __MWERKS__
+#define FRSQRTE( x ) ( (float)__frsqrte( x ) )
+#define FRES( x ) ( (float)__fres( x ) )
+#define FABS( x ) ( (float)__fabs( x ) )
+#define LOW_WORD 1
+#else
+// Native stand-ins with the documented accuracy of the Gekko estimates, so
+// the host test measures the same worst case: the exact value with the
+// mantissa truncated to 5 (frsqrte) or 12 (fres) bits
+#define FRSQRTE( x ) estimate_rsqrt( x )
+#define FRES( x ) estimate_recip( x )
+#define FABS( x ) __builtin_fabsf( x )
+#define LOW_WORD 0
+
+typedef union EstimateBits
+{
+    double d;
+    u64 bits;
+} EstimateBits;
+
+static float truncate_mantissa( double v, u32 bits )
+{
+    EstimateBits b;
+    b.d = v;
+    b.bits &= ~( ( 1ull << ( 52 - bits ) ) - 1 );
+    return (float)b.d;
+}
+
+static float estimate_rsqrt( float x )
+{
+    EstimateBits b;
+    double y;
+    u32 i;
+
+    // Bit trick start, then Newton-Raphson in double to full precision
+    b.d = x;
+    b.bits = 0x5FE6EB50C7B537A9ull - ( b.bits >> 1 );
+    y = b.d;
+    for( i = 0; i < 6; ++i )
+    {
+        y = y * ( 1.5 - 0.5 * x * y * y );
+    }
+    return truncate_mantissa( y, 5 );
+}
+
+static float estimate_recip( float x )
+{
+    return truncate_mantissa( 1.0 / x, 12 );
+}
+#endif
+
+/* ================================ *
+ *     Reciprocals
+ * ================================ */
+
+float fast_rsqrt_lo( float x )
+{
+    float y = FRSQRTE( x );
+    float h = 0.5f * x;
+
+    return y * ( 1.5f - h * y * y );
+}
+
+float fast_rsqrt_hi( float x )
+{
+    float y = FRSQRTE( x );
+    float h = 0.5f * x;
+
+    y = y * ( 1.5f - h * y * y );
+    return y * ( 1.5f - h * y * y );
+}
+
+// y + y * e rather than y * ( 2 - x * y ), e is small and keeps its bits
+float fast_recip_lo( float x )
+{
+    float y = FRES( x );
+
+    return y + y * ( 1.0f - x * y );
+}
+
+float fast_recip_hi( float x )
+{
+    float y = FRES( x );
+
+    y = y + y * ( 1.0f - x * y );
+    return y + y * ( 1.0f - x * y );
+}
+
+/* ================================ *
+ *     Sine and cosine
+ * ================================ */
+
+// sin( 2 * pi * i / FASTMATH_SIN_TABLE_SIZE )
+const float fastSinTable[ FASTMATH_SIN_TABLE_SIZE + 1 ] = {
+    0.0f, 0.0122715383f, 0.0245412285f, 0.0368072229f, 0.0490676743f, 0.0613207363f, 0.0735645636f, 0.0857973123f,
+    0.0980171403f, 0.110222207f, 0.122410675f, 0.134580709f, 0.146730474f, 0.158858143f, 0.170961889f, 0.183039888f,
+    0.195090322f, 0.207111376f, 0.21910124f, 0.231058108f, 0.24298018f, 0.25486566f, 0.266712757f, 0.278519689f,
+    0.290284677f, 0.302005949f, 0.31368174f, 0.325310292f, 0.336889853f, 0.34841868f, 0.359895037f, 0.371317194f,
+    0.382683432f, 0.39399204f, 0.405241314f, 0.41642956f, 0.427555093f, 0.438616239f, 0.44961133f, 0.460538711f,
+    0.471396737f, 0.482183772f, 0.492898192f, 0.503538384f, 0.514102744f, 0.524589683f, 0.53499762f, 0.545324988f,
+    0.555570233f, 0.565731811f, 0.575808191f, 0.585797857f, 0.595699304f, 0.605511041f, 0.615231591f, 0.624859488f,
+    0.634393284f, 0.643831543f, 0.653172843f, 0.662415778f, 0.671558955f, 0.680600998f, 0.689540545f, 0.698376249f,
+    0.707106781f, 0.715730825f, 0.724247083f, 0.732654272f, 0.740951125f, 0.749136395f, 0.757208847f, 0.765167266f,
+    0.773010453f, 0.780737229f, 0.788346428f, 0.795836905f, 0.803207531f, 0.810457198f, 0.817584813f, 0.824589303f,
+    0.831469612f, 0.838224706f, 0.844853565f, 0.851355193f, 0.85772861f, 0.863972856f, 0.870086991f, 0.876070094f,
+    0.881921264f, 0.88763962f, 0.893224301f, 0.898674466f, 0.903989293f, 0.909167983f, 0.914209756f, 0.919113852f,
+    0.923879533f, 0.92850608f, 0.932992799f, 0.937339012f, 0.941544065f, 0.945607325f, 0.949528181f, 0.95330604f,
+    0.956940336f, 0.960430519f, 0.963776066f, 0.966976471f, 0.970031253f, 0.972939952f, 0.97570213f, 0.978317371f,
+    0.98078528f, 0.983105487f, 0.985277642f, 0.987301418f, 0.98917651f, 0.990902635f, 0.992479535f, 0.99390697f,
+    0.995184727f, 0.996312612f, 0.997290457f, 0.998118113f, 0.998795456f, 0.999322385f, 0.999698819f, 0.999924702f,
+    1.0f, 0.999924702f, 0.999698819f, 0.999322385f, 0.998795456f, 0.998118113f, 0.997290457f, 0.996312612f,
+    0.995184727f, 0.99390697f, 0.992479535f, 0.990902635f, 0.98917651f, 0.987301418f, 0.985277642f, 0.983105487f,
+    0.98078528f, 0.978317371f, 0.97570213f, 0.972939952f, 0.970031253f, 0.966976471f, 0.963776066f, 0.960430519f,
+    0.956940336f, 0.95330604f, 0.949528181f, 0.945607325f, 0.941544065f, 0.937339012f, 0.932992799f, 0.92850608f,
+    0.923879533f, 0.919113852f, 0.914209756f, 0.909167983f, 0.903989293f, 0.898674466f, 0.893224301f, 0.88763962f,
+    0.881921264f, 0.876070094f, 0.870086991f, 0.863972856f, 0.85772861f, 0.851355193f, 0.844853565f, 0.838224706f,
+    0.831469612f, 0.824589303f, 0.817584813f, 0.810457198f, 0.803207531f, 0.795836905f, 0.788346428f, 0.780737229f,
+    0.773010453f, 0.765167266f, 0.757208847f, 0.749136395f, 0.740951125f, 0.732654272f, 0.724247083f, 0.715730825f,
+    0.707106781f, 0.698376249f, 0.689540545f, 0.680600998f, 0.671558955f, 0.662415778f, 0.653172843f, 0.643831543f,
+    0.634393284f, 0.624859488f, 0.615231591f, 0.605511041f, 0.595699304f, 0.585797857f, 0.575808191f, 0.565731811f,
+    0.555570233f, 0.545324988f, 0.53499762f, 0.524589683f, 0.514102744f, 0.503538384f, 0.492898192f, 0.482183772f,
+    0.471396737f, 0.460538711f, 0.44961133f, 0.438616239f, 0.427555093f, 0.41642956f, 0.405241314f, 0.39399204f,
+    0.382683432f, 0.371317194f, 0.359895037f, 0.34841868f, 0.336889853f, 0.325310292f, 0.31368174f, 0.302005949f,
+    0.290284677f, 0.278519689f, 0.266712757f, 0.25486566f, 0.24298018f, 0.231058108f, 0.21910124f, 0.207111376f,
+    0.195090322f, 0.183039888f, 0.170961889f, 0.158858143f, 0.146730474f, 0.134580709f, 0.122410675f, 0.110222207f,
+    0.0980171403f, 0.0857973123f, 0.0735645636f, 0.0613207363f, 0.0490676743f, 0.0368072229f, 0.0245412285f, 0.0122715383f,
+    0.0f, -0.0122715383f, -0.0245412285f, -0.0368072229f, -0.0490676743f, -0.0613207363f, -0.0735645636f, -0.0857973123f,
+    -0.0980171403f, -0.110222207f, -0.122410675f, -0.134580709f, -0.146730474f, -0.158858143f, -0.170961889f, -0.183039888f,
+    -0.195090322f, -0.207111376f, -0.21910124f, -0.231058108f, -0.24298018f, -0.25486566f, -0.266712757f, -0.278519689f,
+    -0.290284677f, -0.302005949f, -0.31368174f, -0.325310292f, -0.336889853f, -0.34841868f, -0.359895037f, -0.371317194f,
+    -0.382683432f, -0.39399204f, -0.405241314f, -0.41642956f, -0.427555093f, -0.438616239f, -0.44961133f, -0.460538711f,
+    -0.471396737f, -0.482183772f, -0.492898192f, -0.503538384f, -0.514102744f, -0.524589683f, -0.53499762f, -0.545324988f,
+    -0.555570233f, -0.565731811f, -0.575808191f, -0.585797857f, -0.595699304f, -0.605511041f, -0.615231591f, -0.624859488f,
+    -0.634393284f, -0.643831543f, -0.653172843f, -0.662415778f, -0.671558955f, -0.680600998f, -0.689540545f, -0.698376249f,
+    -0.707106781f, -0.715730825f, -0.724247083f, -0.732654272f, -0.740951125f, -0.749136395f, -0.757208847f, -0.765167266f,
+    -0.773010453f, -0.780737229f, -0.788346428f, -0.795836905f, -0.803207531f, -0.810457198f, -0.817584813f, -0.824589303f,
+    -0.831469612f, -0.838224706f, -0.844853565f, -0.851355193f, -0.85772861f, -0.863972856f, -0.870086991f, -0.876070094f,
+    -0.881921264f, -0.88763962f, -0.893224301f, -0.898674466f, -0.903989293f, -0.909167983f, -0.914209756f, -0.919113852f,
+    -0.923879533f, -0.92850608f, -0.932992799f, -0.937339012f, -0.941544065f, -0.945607325f, -0.949528181f, -0.95330604f,
+    -0.956940336f, -0.960430519f, -0.963776066f, -0.966976471f, -0.970031253f, -0.972939952f, -0.97570213f, -0.978317371f,
+    -0.98078528f, -0.983105487f, -0.985277642f, -0.987301418f, -0.98917651f, -0.990902635f, -0.992479535f, -0.99390697f,
+    -0.995184727f, -0.996312612f, -0.997290457f, -0.998118113f, -0.998795456f, -0.999322385f, -0.999698819f, -0.999924702f,
+    -1.0f, -0.999924702f, -0.999698819f, -0.999322385f, -0.998795456f, -0.998118113f, -0.997290457f, -0.996312612f,
+    -0.995184727f, -0.99390697f, -0.992479535f, -0.990902635f, -0.98917651f, -0.987301418f, -0.985277642f, -0.983105487f,
+    -0.98078528f, -0.978317371f, -0.97570213f, -0.972939952f, -0.970031253f, -0.966976471f, -0.963776066f, -0.960430519f,
+    -0.956940336f, -0.95330604f, -0.949528181f, -0.945607325f, -0.941544065f, -0.937339012f, -0.932992799f, -0.92850608f,
+    -0.923879533f, -0.919113852f, -0.914209756f, -0.909167983f, -0.903989293f, -0.898674466f, -0.893224301f, -0.88763962f,
+    -0.881921264f, -0.876070094f, -0.870086991f, -0.863972856f, -0.85772861f, -0.851355193f, -0.844853565f, -0.838224706f,
+    -0.831469612f, -0.824589303f, -0.817584813f, -0.810457198f, -0.803207531f, -0.795836905f, -0.788346428f, -0.780737229f,
+    -0.773010453f, -0.765167266f, -0.757208847f, -0.749136395f, -0.740951125f, -0.732654272f, -0.724247083f, -0.715730825f,
+    -0.707106781f, -0.698376249f, -0.689540545f, -0.680600998f, -0.671558955f, -0.662415778f, -0.653172843f, -0.643831543f,
+    -0.634393284f, -0.624859488f, -0.615231591f, -0.605511041f, -0.595699304f, -0.585797857f, -0.575808191f, -0.565731811f,
+    -0.555570233f, -0.545324988f, -0.53499762f, -0.524589683f, -0.514102744f, -0.503538384f, -0.492898192f, -0.482183772f,
+    -0.471396737f, -0.460538711f, -0.44961133f, -0.438616239f, -0.427555093f, -0.41642956f, -0.405241314f, -0.39399204f,
+    -0.382683432f, -0.371317194f, -0.359895037f, -0.34841868f, -0.336889853f, -0.325310292f, -0.31368174f, -0.302005949f,
+    -0.290284677f, -0.278519689f, -0.266712757f, -0.25486566f, -0.24298018f, -0.231058108f, -0.21910124f, -0.207111376f,
+    -0.195090322f, -0.183039888f, -0.170961889f, -0.158858143f, -0.146730474f, -0.134580709f, -0.122410675f, -0.110222207f,
+    -0.0980171403f, -0.0857973123f, -0.0735645636f, -0.0613207363f, -0.0490676743f, -0.0368072229f, -0.0245412285f, -0.0122715383f,
+    0.0f,
+};
+
+#define TABLE_MASK ( FASTMATH_SIN_TABLE_SIZE - 1 )
+#define TABLE_SCALE ( FASTMATH_SIN_TABLE_SIZE / ( 2.0 * 3.14159265358979323846 ) )
+#define COS_OFFSET ( FASTMATH_SIN_TABLE_SIZE / 4 )
+
+// Adding 1.5 * 2^52 to a double rounds it to an integer held in the low
+// word, which avoids fctiwz and the int to float conversion
+#define ROUND_MAGIC 6755399441055744.0
+
+typedef union RoundBits
+{
+    double d;
+    u32 w[ 2 ];
+} RoundBits;
+
+static u32 nearest_index( float x )
+{
+    RoundBits b;
+
+    b.d = x * TABLE_SCALE + ROUND_MAGIC;
+    return b.w[ LOW_WORD ];
+}
+
+// Returns floor( t ) and leaves t - floor( t ) in *frac
+static u32 floor_index( float x, float *frac )
+{
+    RoundBits b;
+    double t = x * TABLE_SCALE;
+
+    b.d = ( t - 0.5 ) + ROUND_MAGIC;
+    *frac = (float)( t - ( b.d - ROUND_MAGIC ) );
+    return b.w[ LOW_WORD ];
+}
+
+static float lerp_table( u32 i, float frac )
+{
+    float a = fastSinTable[ i & TABLE_MASK ];
+    float b = fastSinTable[ ( i & TABLE_MASK ) + 1 ];
+
+    return a + frac * ( b - a );
+}
+
+float fast_sin_lo( float x )
+{
+    return fastSinTable[ nearest_index( x ) & TABLE_MASK ];
+}
+
+float fast_cos_lo( float x )
+{
+    return fastSinTable[ ( nearest_index( x ) + COS_OFFSET ) & TABLE_MASK ];
+}
+
+float fast_sin_hi( float x )
+{
+    float frac;
+    u32 i = floor_index( x, &frac );
+
+    return lerp_table( i, frac );
+}
+
+float fast_cos_hi( float x )
+{
+    float frac;
+    u32 i = floor_index( x, &frac );
+
+    return lerp_table( i + COS_OFFSET, frac );
+}
+
+/* ================================ *
+ *     atan2
+ * ================================ */
+
+// Folds atan( a ), a in [0, 1], into the octant of ( y, x ). y = -0 is
+// treated as +0.
+static float atan2_octant( float r, float ay, float ax, float y, float x )
+{
+    if( ay > ax )
+    {
+        r = FASTMATH_PI / 2 - r;
+    }
+    if( x < 0.0f )
+    {
+        r = FASTMATH_PI - r;
+    }
+    return y < 0.0f ? -r : r;
+}
+
+float fast_atan2_lo( float y, float x )
+{
+    float ax = FABS( x );
+    float ay = FABS( y );
+    float hi = ax > ay ? ax : ay;
+    float a;
+
+    if( hi == 0.0f )
+    {
+        return 0.0f;
+    }
+    a = ( ax > ay ? ay : ax ) * fast_recip_lo( hi );
+
+    // pi/4 a + 0.273 a ( 1 - a )
+    return atan2_octant( a * ( FASTMATH_PI / 4 + 0.273f * ( 1.0f - a ) ), ay, ax, y, x );
+}
+
+float fast_atan2_hi( float y, float x )
+{
+    float ax = FABS( x );
+    float ay = FABS( y );
+    float hi = ax > ay ? ax : ay;
+    float a;
+    float s;
+
+    if( hi == 0.0f )
+    {
+        return 0.0f;
+    }
+    a = ( ax > ay ? ay : ax ) * fast_recip_lo( hi );
+    s = a * a;
+
+    // Degree 9 odd polynomial, Abramowitz and Stegun 4.4.47
+    return atan2_octant(
+        ( ( ( ( 0.0208351f * s - 0.0851330f ) * s + 0.1801410f ) * s - 0.3302995f ) * s + 0.9998660f ) * a, ay, ax, y, x );
+}
+
+/* ================================ *
+ *     Vec3
+ * ================================ */
+
+float vec3_length( const Vec3 *v )
+{
+    float sq = v->x * v->x + v->y * v->y + v->z * v->z;
+
+    if( sq <= 0.0f )
+    {
+        return 0.0f;
+    }
+    return sq * fast_rsqrt_hi( sq );
+}
+
+float vec3_normalize( Vec3 *out, const Vec3 *v )
+{
+    float x = v->x;
+    float y = v->y;
+    float z = v->z;
+    float sq = x * x + y * y + z * z;
+    float r;
+
+    if( sq <= 0.0f )
+    {
+        out->x = x;
+        out->y = y;
+        out->z = z;
+        return 0.0f;
+    }
+
+    r = fast_rsqrt_hi( sq );
+    out->x = x * r;
+    out->y = y * r;
+    out->z = z * r;
+    return sq * r;
+}
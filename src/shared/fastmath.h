@@ -0,0 +1,88 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <Common.h>
+
+#include "stuff.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Fast math
+ * ================================ */
+
+// Every function has a _lo and a _hi variant; the unsuffixed macros pick
+// one by FASTMATH_ACCURACY, which can be set per TU before the include.
+//
+// Max errors are measured over the input ranges below by test_fastmath in
+// src/native/test_main.c, using the documented frsqrte/fres estimate
+// accuracy (1/32 and 1/4096) rather than the hardware. Cycles are Gekko
+// dependency-chain estimates for the body including the call, not counting
+// cache misses; the bench DOL measures them for real.
+//
+//   function       max error                      cycles
+//   rsqrt_lo       1.4e-3 relative                ~14     1 Newton-Raphson step
+//   rsqrt_hi       2.8e-6 relative                ~24     2 steps
+//   recip_lo       1.4e-7 relative                ~10     1 step
+//   recip_hi       9.8e-8 relative (float limit)  ~16     2 steps
+//   sin/cos_lo     6.1e-3 absolute                ~16     nearest table entry
+//   sin/cos_hi     1.9e-5 absolute                ~22     linear interpolation
+//   atan2_lo       3.8e-3 rad                     ~32
+//   atan2_hi       1.2e-5 rad                     ~40
+//   vec3_length    2.8e-6 relative                ~34
+//
+// rsqrt/recip take positive finite inputs, sin/cos |x| < 1e6 radians.
+
+#define FASTMATH_LO 0
+#define FASTMATH_HI 1
+
+#ifndef FASTMATH_ACCURACY
+#define FASTMATH_ACCURACY FASTMATH_HI
+#endif
+
+// Entries per turn, a power of two; the table holds one extra for
+// interpolating past the last entry
+#define FASTMATH_SIN_TABLE_SIZE 512
+
+#define FASTMATH_PI 3.14159265358979323846f
+
+extern const float fastSinTable[ FASTMATH_SIN_TABLE_SIZE + 1 ];
+
+float fast_rsqrt_lo( float x );
+float fast_rsqrt_hi( float x );
+float fast_recip_lo( float x );
+float fast_recip_hi( float x );
+float fast_sin_lo( float x );
+float fast_sin_hi( float x );
+float fast_cos_lo( float x );
+float fast_cos_hi( float x );
+float fast_atan2_lo( float y, float x );
+float fast_atan2_hi( float y, float x );
+
+#if FASTMATH_ACCURACY == FASTMATH_LO
+#define fast_rsqrt fast_rsqrt_lo
+#define fast_recip fast_recip_lo
+#define fast_sin fast_sin_lo
+#define fast_cos fast_cos_lo
+#define fast_atan2 fast_atan2_lo
+#else
+#define fast_rsqrt fast_rsqrt_hi
+#define fast_recip fast_recip_hi
+#define fast_sin fast_sin_hi
+#define fast_cos fast_cos_hi
+#define fast_atan2 fast_atan2_hi
+#endif
+
+// Always use the _hi reciprocal square root, a zero vector has length 0 and
+// normalizes to itself
+float vec3_length( const Vec3 *v );
+float vec3_normalize( Vec3 *out, const Vec3 *v ); // Returns the length
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+#include <runtime_time.h>
+
+#include "profile.h"
+
+// Never compiled with -profile itself, the hooks would recurse
+
+static_assert( ( PROFILE_MAX_FUNCS & ( PROFILE_MAX_FUNCS - 1 ) ) == 0 );
+
+typedef struct ProfileFrame
+{
+    ProfileEntry *entry;
+    u32 start;
+    u32 children; // Ticks spent in profiled callees
+} ProfileFrame;
+
+ProfileTable __profile_table = { PROFILE_MAGIC, PROFILE_VERSION, PROFILE_MAX_FUNCS };
+
+static ProfileFrame profileStack[ PROFILE_MAX_DEPTH ];
+static u32 profileDepth; // May exceed PROFILE_MAX_DEPTH, those frames aren't stored
+
+// Open addressing with linear probing, keys are never removed
+static ProfileEntry *profile_lookup( u32 key, u32 pc )
+{
+    u32 i = ( key * 0x9E3779B1 ) >> 16;
+    u32 n;
+    ProfileEntry *entry;
+
+    for( n = 0; n < PROFILE_MAX_FUNCS; ++n )
+    {
+        entry = &__profile_table.entries[ ( i + n ) & ( PROFILE_MAX_FUNCS - 1 ) ];
+        if( entry->key == key )
+        {
+            return entry;
+        }
+        if( entry->key == 0 )
+        {
+            entry->key = key;
+            entry->pc = pc;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void profile_enter( u32 key, u32 pc )
+{
+    ProfileEntry *entry = profile_lookup( key, pc );
+    ProfileFrame *frame;
+
+    if( entry )
+    {
+        ++entry->calls;
+    }
+    else
+    {
+        ++__profile_table.dropped;
+    }
+
+    if( profileDepth >= PROFILE_MAX_DEPTH )
+    {
+        ++profileDepth;
+        return;
+    }
+
+    frame = &profileStack[ profileDepth++ ];
+    frame->entry = entry;
+    frame->children = 0;
+    // Read last so the bookkeeping above isn't charged to the function
+    frame->start = runtime_ticks( );
+}
+
+void profile_exit( void )
+{
+    u32 now = runtime_ticks( );
+    ProfileFrame *frame;
+    u32 elapsed;
+
+    if( profileDepth == 0 )
+    {
+        return;
+    }
+    if( --profileDepth >= PROFILE_MAX_DEPTH )
+    {
+        return;
+    }
+
+    frame = &profileStack[ profileDepth ];
+    elapsed = now - frame->start;
+    if( frame->entry )
+    {
+        frame->entry->inclusive += elapsed;
+        frame->entry->exclusive += elapsed - frame->children;
+    }
+    if( profileDepth > 0 )
+    {
+        profileStack[ profileDepth - 1 ].children += elapsed;
+    }
+}
+
+#ifdef __MWERKS__
+// The return address in LR points into the profiled function
+asm void __PROFILE_ENTRY( char *name )
+{
+    // clang-format off
+    nofralloc
+
+    mflr r4
+    b profile_enter
+    // clang-format on
+}
+
+asm void __PROFILE_EXIT( char *name )
+{
+    // clang-format off
+    nofralloc
+
+    b profile_exit
+    // clang-format on
+}
+#else
+void __PROFILE_ENTRY( char *name )
+{
+    profile_enter( (u32)(uintptr_t)name, (u32)(uintptr_t)__builtin_return_address( 0 ) );
+}
+
+void __PROFILE_EXIT( char *name )
+{
+    profile_exit( );
+}
+#endif
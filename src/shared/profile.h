@@ -0,0 +1,59 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Common.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ================================ *
+ *     Function profiler
+ * ================================ */
+
+// Objects built with `profile=True` in the profiling DOL are compiled with
+// `-profile on`, which makes mwcc call __PROFILE_ENTRY/__PROFILE_EXIT with
+// the function name in r3. Calls and inclusive/exclusive time base ticks are
+// kept per function; multiply by 12 for Gekko CPU cycles.
+
+#define PROFILE_MAX_FUNCS 256 // Hash table slots, must be a power of two
+#define PROFILE_MAX_DEPTH 64  // Deeper calls are counted but not timed
+
+#define PROFILE_MAGIC 0x50524F46 // 'PROF'
+#define PROFILE_VERSION 1
+
+typedef struct ProfileEntry
+{
+    u32 key; // Function name pointer, 0 for an empty slot
+    u32 pc;  // Return address of the first entry hook call, inside the function
+    u32 calls;
+    u32 pad;
+    u64 inclusive;
+    u64 exclusive;
+} ProfileEntry;
+
+// Layout is read back from a memory dump by tools/profile_report.py
+typedef struct ProfileTable
+{
+    u32 magic;
+    u32 version;
+    u32 capacity;
+    u32 dropped; // Calls to functions that didn't fit in the table
+    ProfileEntry entries[ PROFILE_MAX_FUNCS ];
+} ProfileTable;
+
+extern ProfileTable __profile_table;
+
+// Bookkeeping behind the hooks, `pc` only identifies the function in reports
+void profile_enter( u32 key, u32 pc );
+void profile_exit( void );
+
+void __PROFILE_ENTRY( char *name );
+void __PROFILE_EXIT( char *name );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
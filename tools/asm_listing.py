@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+
+###
+# Side-by-side listing of a unit's target and base disassembly.
+#
+# Reads the `objdump -dr` output of both objects (`ninja asm` writes them to
+# build/asm/{target,base}), pairs functions by section and name and aligns
+# their instructions and relocations. Lines are marked ' ' when equal,
+# '|' when changed, '<' when only in the target and '>' when only in the
+# base, so `grep -n '^ *[|<>] '` style searches and ordinary diff tools
+# work on the result. Branch targets are compared by label, not offset.
+#
+# Usage:
+#   python3 tools/asm_listing.py target.s base.s -o unit.txt --unit main_content/01_abi_basics.c
+###
+
+import argparse
+import difflib
+import re
+import sys
+from typing import Dict, List, NamedTuple, Optional, Tuple
+
+FUNCTION = re.compile(r"^([0-9a-fA-F]+) <(.+)>:$")
+SECTION = re.compile(r"^Disassembly of section (\S+):$")
+INSTRUCTION = re.compile(r"^\s*([0-9a-fA-F]+):\s+((?:[0-9a-fA-F]{2} ){3}[0-9a-fA-F]{2})\s*\t?(.*)$")
+RELOCATION = re.compile(r"^\s+([0-9a-fA-F]+):\s+(R_\w+)\s+(.*)$")
+# `bl 1c <func+0xc>` differs by position only, keep the label
+BRANCH_TARGET = re.compile(r"\b(?:0x)?[0-9a-fA-F]+ (<[^>]+>)")
+
+WIDTH = 56
+
+
+class Line(NamedTuple):
+    text: str  # As shown
+    key: str  # As compared
+
+
+def parse_listing(path: str) -> Dict[Tuple[str, str], List[Line]]:
+    """Lines per (section, function) in listing order."""
+    functions: Dict[Tuple[str, str], List[Line]] = {}
+    section = ""
+    current: Optional[List[Line]] = None
+    start = 0
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for raw in f:
+            raw = raw.rstrip("\n")
+            m = SECTION.match(raw)
+            if m:
+                section = m.group(1)
+                current = None
+                continue
+            m = FUNCTION.match(raw)
+            if m:
+                start = int(m.group(1), 16)
+                current = functions.setdefault((section, m.group(2)), [])
+                continue
+            if current is None:
+                continue
+            m = RELOCATION.match(raw)
+            if m:
+                offset = int(m.group(1), 16) - start
+                text = f"{m.group(2)} {m.group(3).strip()}"
+                current.append(Line(f"{offset:6x}:   {text}", f"reloc {text}"))
+                continue
+            m = INSTRUCTION.match(raw)
+            if m:
+                offset = int(m.group(1), 16) - start
+                asm = " ".join(m.group(3).split())
+                current.append(Line(f"{offset:6x}: {m.group(2).replace(' ', '')} {asm}", BRANCH_TARGET.sub(r"\1", asm)))
+    return functions
+
+
+def side_by_side(left: List[Line], right: List[Line]) -> Tuple[List[str], bool]:
+    """Aligned rows for one function and whether anything differs."""
+    rows: List[str] = []
+
+    def row(a: Optional[Line], marker: str, b: Optional[Line]) -> None:
+        rows.append(f"{(a.text if a else ''):<{WIDTH}} {marker} {b.text if b else ''}".rstrip())
+
+    matcher = difflib.SequenceMatcher(None, [l.key for l in left], [l.key for l in right], autojunk=False)
+    for op, i1, i2, j1, j2 in matcher.get_opcodes():
+        if op == "equal":
+            for a, b in zip(left[i1:i2], right[j1:j2]):
+                row(a, " ", b)
+            continue
+        pairs = min(i2 - i1, j2 - j1)
+        for k in range(pairs):
+            row(left[i1 + k], "|", right[j1 + k])
+        for a in left[i1 + pairs : i2]:
+            row(a, "<", None)
+        for b in right[j1 + pairs : j2]:
+            row(None, ">", b)
+    return rows, any(op != "equal" for op, *_ in matcher.get_opcodes())
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("target", help="objdump -dr listing of the target object")
+    parser.add_argument("base", help="objdump -dr listing of the base object")
+    parser.add_argument("-o", "--output", help="write here instead of stdout")
+    parser.add_argument("--unit", help="name shown in the header")
+    args = parser.parse_args()
+
+    target = parse_listing(args.target)
+    base = parse_listing(args.base)
+    # Target order first, then anything only the base has
+    keys = list(target) + [k for k in base if k not in target]
+
+    body: List[str] = []
+    differing: List[str] = []
+    for key in keys:
+        section, name = key
+        if key not in base:
+            status = "only in target"
+        elif key not in target:
+            status = "only in base"
+        else:
+            status = ""
+        rows, changed = side_by_side(target.get(key, []), base.get(key, []))
+        if changed:
+            differing.append(name)
+            status = status or "differs"
+        body.append(f"{section} {name}" + (f"  [{status}]" if status else ""))
+        body.extend(rows)
+        body.append("")
+
+    header = [
+        f"# {args.unit or args.target}: {len(keys)} functions, {len(differing)} differ",
+        f"# {'target':<{WIDTH - 2}}   base",
+    ]
+    if differing:
+        header.append(f"# differ: {' '.join(differing)}")
+    text = "\n".join(header + [""] + body)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
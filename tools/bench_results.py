@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+
+###
+# Extracts benchmark results from a memory dump of the benchmark DOL.
+#
+# The table is located through the __bench_results symbol in the link map;
+# without a map the dump is scanned for the table's magic instead.
+#
+# Usage:
+#   python3 tools/bench_results.py mem1.raw --map build/src/bench/main.elf.MAP
+###
+
+import argparse
+import json
+import os
+import struct
+import sys
+from typing import Any, Dict, List
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from linkmap import find_in_dump, parse_map
+
+# Must match src/shared/bench.h
+BENCH_MAGIC = 0x424E4348
+BENCH_VERSION = 2
+BENCH_MAX_CASES = 64
+BENCH_NAME_LEN = 24
+
+TABLE_HEADER = struct.Struct(">5I")
+RESULT = struct.Struct(f">{BENCH_NAME_LEN}s4I")
+
+# Time base ticks -> Gekko CPU cycles
+TICKS_TO_CYCLES = 12
+
+
+def read_results(dump: bytes, offset: int) -> Dict[str, Any]:
+    magic, version, count, overhead, dropped = TABLE_HEADER.unpack_from(dump, offset)
+    if magic != BENCH_MAGIC:
+        sys.exit(f"Bad magic {magic:#x} at offset {offset:#x}, did the benchmarks run?")
+    if version != BENCH_VERSION:
+        sys.exit(f"Unsupported table version {version}")
+
+    results: List[Dict[str, Any]] = []
+    pos = offset + TABLE_HEADER.size
+    for _ in range(min(count, BENCH_MAX_CASES)):
+        name, reps, lo, median, hi = RESULT.unpack_from(dump, pos)
+        pos += RESULT.size
+        results.append(
+            {
+                "name": name.split(b"\0", 1)[0].decode("ascii", "replace"),
+                "reps": reps,
+                "min": lo,
+                "median": median,
+                "max": hi,
+            }
+        )
+    return {"overhead": overhead, "dropped": dropped, "results": results}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("dump", help="raw memory dump")
+    parser.add_argument("--map", help="MWLD map of the benchmark DOL")
+    parser.add_argument(
+        "--base",
+        type=lambda x: int(x, 0),
+        default=0x80000000,
+        help="address of the first byte of the dump",
+    )
+    parser.add_argument("--json", help="also write results to this file")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    link_map = parse_map(args.map) if args.map else None
+    table = read_results(dump, find_in_dump(dump, args.base, link_map, "__bench_results", BENCH_MAGIC, BENCH_VERSION, "Benchmark table"))
+
+    print(f"Timing overhead: {table['overhead']} ticks (subtracted)")
+    if table["dropped"]:
+        print(f"Warning: {table['dropped']} cases dropped, raise BENCH_MAX_CASES in src/shared/bench.h")
+    print(f"{'case':<{BENCH_NAME_LEN}}{'reps':>6}{'min':>10}{'median':>10}{'max':>10}{'~cycles':>10}")
+    for r in table["results"]:
+        print(
+            f"{r['name']:<{BENCH_NAME_LEN}}{r['reps']:>6}{r['min']:>10}"
+            f"{r['median']:>10}{r['max']:>10}{r['median'] * TICKS_TO_CYCLES:>10}"
+        )
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(table, f, indent=4)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,374 @@
+#!/usr/bin/env python3
+
+###
+# Packs JSON data into a relocatable blob for src/shared/blob.h.
+#
+# The input declares C-like struct types and a root value:
+#   {
+#     "types": {
+#       "Item": [["u32", "id"], ["f32", "weight"], ["str", "name"], ["Item*", "next"]],
+#       "Table": [["u32", "count"], ["Item*", "items"], ["u16[4]", "flags"]]
+#     },
+#     "root": ["Table", {"count": 2, "items": [{"id": 1}, {"id": 2}], "flags": [1, 2, 3, 4]}]
+#   }
+# Field types are u8/s8/u16/s16/u32/s32/u64/s64/f32/f64, a declared struct,
+# `str` (a char * to a NUL-terminated string), `T*` and `T[N]`. A pointer's
+# value is an object, a list (a contiguous array), null, or "#label" to
+# point at the object that has "#": "label". Missing struct fields are zero.
+#
+# Pointers are written as offsets from the blob start and listed in a
+# sorted fixup table, so blob_load only touches the pointers. Layout follows
+# the target ABI (big-endian, 4-byte pointers, natural alignment); --native
+# uses the host's instead, for the native tests.
+#
+# Usage:
+#   python3 tools/blob_pack.py data.json -o data.blob
+#   python3 tools/blob_pack.py data.json -o data.c --c dataBlob --types data_types.h
+###
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+from typing import Any, Dict, List, NamedTuple, Optional, Tuple, Union
+
+BLOB_MAGIC = 0x424C4F42  # 'BLOB'
+BLOB_VERSION = 1
+
+SCALARS = {
+    # name: (struct format, C type)
+    "u8": ("B", "u8"),
+    "s8": ("b", "s8"),
+    "u16": ("H", "u16"),
+    "s16": ("h", "s16"),
+    "u32": ("I", "u32"),
+    "s32": ("i", "s32"),
+    "u64": ("Q", "u64"),
+    "s64": ("q", "s64"),
+    "f32": ("f", "f32"),
+    # Common.h's f64 is a float
+    "f64": ("d", "double"),
+}
+
+ARRAY = re.compile(r"^(.*)\[(\d+)\]$")
+
+
+class Scalar(NamedTuple):
+    name: str
+
+
+class Str(NamedTuple):
+    pass
+
+
+class Pointer(NamedTuple):
+    target: "Type"
+
+
+class Array(NamedTuple):
+    element: "Type"
+    count: int
+
+
+class StructRef(NamedTuple):
+    name: str
+
+
+Type = Union[Scalar, Str, Pointer, Array, StructRef]
+
+
+class PackError(Exception):
+    pass
+
+
+def parse_type(text: str, structs: Dict[str, Any]) -> Type:
+    text = text.strip()
+    m = ARRAY.match(text)
+    if m:
+        return Array(parse_type(m.group(1), structs), int(m.group(2)))
+    if text.endswith("*"):
+        return Pointer(parse_type(text[:-1], structs))
+    if text in SCALARS:
+        return Scalar(text)
+    if text == "str":
+        return Str()
+    if text in structs:
+        return StructRef(text)
+    raise PackError(f"unknown type `{text}`")
+
+
+class Layout:
+    """Sizes and offsets under the target or host ABI."""
+
+    def __init__(self, types: Dict[str, List[List[str]]], big_endian: bool, pointer_size: int) -> None:
+        self.endian = ">" if big_endian else "<"
+        self.pointer_size = pointer_size
+        self.fields: Dict[str, List[Tuple[str, Type, int]]] = {}
+        self.sizes: Dict[str, Tuple[int, int]] = {}
+        for name, fields in types.items():
+            self.fields[name] = []
+            for field in fields:
+                if len(field) != 2:
+                    raise PackError(f"{name}: fields are [type, name] pairs")
+                self.fields[name].append((field[1], parse_type(field[0], types), 0))
+        for name in types:
+            self.struct_layout(name, [])
+
+    def struct_layout(self, name: str, stack: List[str]) -> Tuple[int, int]:
+        if name in self.sizes:
+            return self.sizes[name]
+        if name in stack:
+            raise PackError(f"{name} contains itself, use a pointer")
+        offset = 0
+        align = 1
+        fields = []
+        for field, t, _ in self.fields[name]:
+            size, field_align = self.size_align(t, stack + [name])
+            offset = (offset + field_align - 1) & -field_align
+            fields.append((field, t, offset))
+            offset += size
+            align = max(align, field_align)
+        self.fields[name] = fields
+        self.sizes[name] = ((offset + align - 1) & -align, align)
+        return self.sizes[name]
+
+    def size_align(self, t: Type, stack: Optional[List[str]] = None) -> Tuple[int, int]:
+        if isinstance(t, Scalar):
+            size = struct.calcsize(SCALARS[t.name][0])
+            return size, size
+        if isinstance(t, (Str, Pointer)):
+            return self.pointer_size, self.pointer_size
+        if isinstance(t, Array):
+            size, align = self.size_align(t.element, stack)
+            return size * t.count, align
+        return self.struct_layout(t.name, stack or [])
+
+
+class Packer:
+    def __init__(self, layout: Layout) -> None:
+        self.layout = layout
+        self.data = bytearray()
+        self.fixups: List[int] = []
+        self.labels: Dict[str, int] = {}
+        self.label_refs: List[Tuple[int, str]] = []
+        self.strings: Dict[str, int] = {}
+        # (pointer offset, target type or None for a string, value), placed
+        # breadth-first
+        self.pending: List[Tuple[int, Optional[Type], Any]] = []
+
+    def alloc(self, size: int, align: int) -> int:
+        offset = (len(self.data) + align - 1) & -align
+        self.data.extend(bytes(offset + size - len(self.data)))
+        return offset
+
+    def put(self, fmt: str, offset: int, value: Any) -> None:
+        struct.pack_into(self.layout.endian + fmt, self.data, offset, value)
+
+    def put_pointer(self, offset: int, target: int) -> None:
+        self.put("I" if self.layout.pointer_size == 4 else "Q", offset, target)
+        self.fixups.append(offset)
+
+    def write(self, offset: int, t: Type, value: Any, where: str) -> None:
+        if isinstance(t, Scalar):
+            fmt = SCALARS[t.name][0]
+            if not isinstance(value, (int, float)) or (fmt not in "fd" and not isinstance(value, int)):
+                raise PackError(f"{where}: expected a number for {t.name}, got {value!r}")
+            try:
+                self.put(fmt, offset, value)
+            except struct.error as e:
+                raise PackError(f"{where}: {value} doesn't fit {t.name} ({e})")
+        elif isinstance(t, Array):
+            if not isinstance(value, list) or len(value) > t.count:
+                raise PackError(f"{where}: expected at most {t.count} elements")
+            size, _ = self.layout.size_align(t.element)
+            for i, element in enumerate(value):
+                self.write(offset + i * size, t.element, element, f"{where}[{i}]")
+        elif isinstance(t, StructRef):
+            if not isinstance(value, dict):
+                raise PackError(f"{where}: expected an object for {t.name}")
+            if "#" in value:
+                if value["#"] in self.labels:
+                    raise PackError(f"{where}: label {value['#']} defined twice")
+                self.labels[value["#"]] = offset
+            known = {field for field, _, _ in self.layout.fields[t.name]}
+            unknown = set(value) - known - {"#"}
+            if unknown:
+                raise PackError(f"{where}: {t.name} has no field {', '.join(sorted(unknown))}")
+            for field, field_type, field_offset in self.layout.fields[t.name]:
+                if field in value:
+                    self.write(offset + field_offset, field_type, value[field], f"{where}.{field}")
+        elif value is None:
+            pass  # NULL, not fixed up
+        elif isinstance(t, Str):
+            if not isinstance(value, str):
+                raise PackError(f"{where}: expected a string")
+            self.pending.append((offset, None, value))
+        elif isinstance(value, str) and value.startswith("#"):
+            self.label_refs.append((offset, value[1:]))
+        else:
+            self.pending.append((offset, t.target, value))
+
+    def place_pending(self) -> None:
+        i = 0
+        while i < len(self.pending):
+            offset, t, value = self.pending[i]
+            i += 1
+            if t is None:
+                if value not in self.strings:
+                    encoded = value.encode("utf-8") + b"\0"
+                    self.strings[value] = self.alloc(len(encoded), 1)
+                    self.data[self.strings[value] : self.strings[value] + len(encoded)] = encoded
+                self.put_pointer(offset, self.strings[value])
+                continue
+            elements = value if isinstance(value, list) else [value]
+            size, align = self.layout.size_align(t)
+            target = self.alloc(size * len(elements), align)
+            for k, element in enumerate(elements):
+                self.write(target + k * size, t, element, f"@{target + k * size:#x}")
+            self.put_pointer(offset, target)
+
+        for offset, label in self.label_refs:
+            if label not in self.labels:
+                raise PackError(f"undefined label #{label}")
+            self.put_pointer(offset, self.labels[label])
+
+
+def pack(doc: Dict[str, Any], big_endian: bool, pointer_size: int) -> Tuple[bytes, Layout, str]:
+    """Returns the blob, the layout and the root type name."""
+    layout = Layout(doc.get("types", {}), big_endian, pointer_size)
+    root = doc.get("root")
+    if not isinstance(root, list) or len(root) != 2:
+        raise PackError('root must be ["Type", value]')
+    root_type = parse_type(root[0], layout.fields)
+
+    packer = Packer(layout)
+    # Header: magic, version, pointerSize, size, root, fixupOffset, fixupCount, pad, base
+    header_align = max(4, pointer_size)
+    header_size = (32 + pointer_size + header_align - 1) & -header_align
+    packer.alloc(header_size, header_align)
+    size, align = layout.size_align(root_type)
+    root_offset = packer.alloc(size, max(align, 8))
+    packer.write(root_offset, root_type, root[1], "root")
+    packer.place_pending()
+
+    fixups = sorted(packer.fixups)
+    fixup_offset = packer.alloc(4 * len(fixups), 4)
+    for i, fixup in enumerate(fixups):
+        packer.put("I", fixup_offset + 4 * i, fixup)
+    total = packer.alloc(0, 8)
+
+    header = struct.pack(
+        packer.layout.endian + "8I", BLOB_MAGIC, BLOB_VERSION, pointer_size, total, root_offset, fixup_offset, len(fixups), 0
+    )
+    packer.data[: len(header)] = header
+    return bytes(packer.data), layout, root[0]
+
+
+def c_declaration(layout: Layout, t: Type, name: str) -> str:
+    if isinstance(t, Array):
+        return c_declaration(layout, t.element, f"{name}[ {t.count} ]")
+    if isinstance(t, Pointer):
+        return c_declaration(layout, t.target, f"*{name}")
+    if isinstance(t, Str):
+        return f"char *{name}"
+    if isinstance(t, Scalar):
+        return f"{SCALARS[t.name][1]} {name}"
+    return f"{t.name} {name}"
+
+
+def inline_structs(t: Type) -> List[str]:
+    if isinstance(t, Array):
+        return inline_structs(t.element)
+    if isinstance(t, StructRef):
+        return [t.name]
+    return []
+
+
+def types_header(layout: Layout, guard: str, source: str, blob_name: Optional[str], root: str) -> str:
+    """Struct definitions matching the layout, dependencies first."""
+    order: List[str] = []
+
+    def visit(name: str) -> None:
+        if name in order:
+            return
+        for _, t, _ in layout.fields[name]:
+            for dep in inline_structs(t):
+                visit(dep)
+        order.append(name)
+
+    for name in layout.fields:
+        visit(name)
+
+    lines = [
+        f"// Generated by tools/blob_pack.py from {source}, do not edit",
+        "",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        "#include <Common.h>",
+        "",
+    ]
+    if blob_name:
+        lines[-1:-1] = ["#include <blob.h>"]
+    lines += [f"typedef struct {name} {name};" for name in order]
+    for name in order:
+        lines += ["", f"struct {name}", "{"]
+        decls = [(c_declaration(layout, t, field) + ";", offset) for field, t, offset in layout.fields[name]]
+        width = max((len(d) for d, _ in decls), default=0)
+        for decl, offset in decls:
+            lines.append(f"    {decl:<{width}} // {offset:#x}")
+        size, _ = layout.sizes[name]
+        lines.append(f"}}; // {size:#x}")
+    if blob_name:
+        lines += ["", f"// blob_load( {blob_name} ) returns the {root} *", f"extern BLOB_DATA u64 {blob_name}[];"]
+    lines += ["", "#endif", ""]
+    return "\n".join(lines)
+
+
+def c_source(blob: bytes, name: str, big_endian: bool, source: str, types: Optional[str]) -> str:
+    words = struct.unpack((">" if big_endian else "<") + f"{len(blob) // 8}Q", blob)
+    lines = [f"// Generated by tools/blob_pack.py from {source}, do not edit", "", "#include <blob.h>", ""]
+    if types:
+        lines += [f'#include "{os.path.basename(types)}"', ""]
+    lines.append(f"BLOB_DATA u64 {name}[ {len(words)} ] = {{")
+    for i in range(0, len(words), 4):
+        lines.append("    " + " ".join(f"0x{w:016X}ULL," for w in words[i : i + 4]))
+    lines += ["};", ""]
+    return "\n".join(lines)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("input", help="JSON description")
+    parser.add_argument("-o", "--output", required=True, help="blob, or C source with --c")
+    parser.add_argument("--c", metavar="NAME", help="write a C array called NAME instead of raw bytes")
+    parser.add_argument("--types", metavar="HEADER", help="also write the struct definitions")
+    parser.add_argument("--native", action="store_true", help="host byte order and pointer size")
+    args = parser.parse_args()
+
+    big_endian = not args.native or sys.byteorder == "big"
+    pointer_size = struct.calcsize("P") if args.native else 4
+    with open(args.input, encoding="utf-8") as f:
+        doc = json.load(f)
+    try:
+        blob, layout, root = pack(doc, big_endian, pointer_size)
+    except PackError as e:
+        sys.exit(f"{args.input}: {e}")
+
+    source = args.input.replace(os.sep, "/")
+    if args.c:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(c_source(blob, args.c, big_endian, source, args.types))
+    else:
+        with open(args.output, "wb") as f:
+            f.write(blob)
+    if args.types:
+        guard = re.sub(r"\W", "_", os.path.basename(args.types)).upper()
+        with open(args.types, "w", encoding="utf-8") as f:
+            f.write(types_header(layout, guard, source, args.c, root))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,292 @@
+#!/usr/bin/env python3
+
+###
+# Summarizes build times from .ninja_log.
+#
+# Every edge of the most recent build is attributed to a phase based on the
+# rule configure.py gave it (tool downloads, mwcc compiles, mwld links, DOL
+# conversion). Each phase reports its summed edge time, its wall time (the
+# union of its edges' [start, end] intervals, so parallel edges count once)
+# and its share of the critical path. Outputs are listed by duration, and a
+# summary line is appended to a history file so build performance can be
+# compared across commits.
+#
+# Usage:
+#   python3 tools/buildstats.py build.ninja .ninja_log --history build/buildstats.jsonl
+###
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import time
+from typing import Dict, List, Match, NamedTuple, Optional, Set, Tuple
+
+# Rule name -> phase, matching the rules written by configure.py
+PHASES: Dict[str, str] = {
+    "download_tool": "tools",
+    "mwcc": "compile",
+    "mwcc_pch": "pch",
+    "mwld": "link",
+    "elf2dol": "dol",
+    "cache_fetch": "cache",
+    "cache_store": "cache",
+}
+
+
+class LogEntry(NamedTuple):
+    start: int
+    end: int
+    output: str
+
+    @property
+    def duration(self) -> int:
+        return self.end - self.start
+
+
+class Edge(NamedTuple):
+    rule: str
+    inputs: List[str]
+
+
+def read_ninja_log(path: str, ignore: Set[str]) -> List[LogEntry]:
+    """Returns the entries of the most recent build in a v5+ .ninja_log."""
+    with open(path, "r", encoding="utf-8") as f:
+        header = f.readline()
+        if not header.startswith("# ninja log v"):
+            raise ValueError(f"{path}: not a ninja log")
+
+        builds: List[List[LogEntry]] = [[]]
+        last_end = 0
+        for line in f:
+            fields = line.rstrip("\n").split("\t")
+            if len(fields) < 5:
+                continue
+            entry = LogEntry(int(fields[0]), int(fields[1]), fields[3])
+            if entry.output in ignore:
+                continue
+            # Ninja logs edges in completion order, so end times only go
+            # backwards when a new build started.
+            if entry.end < last_end:
+                builds.append([])
+            builds[-1].append(entry)
+            last_end = entry.end
+
+    # Later entries of the same output within a build win
+    latest: Dict[str, LogEntry] = {}
+    for entry in builds[-1]:
+        latest[entry.output] = entry
+    return list(latest.values())
+
+
+def read_build_graph(path: str) -> Dict[str, Edge]:
+    """Maps every output in a build.ninja to its rule and explicit/implicit inputs."""
+    graph: Dict[str, Edge] = {}
+    variables: Dict[str, str] = {}
+    with open(path, "r", encoding="utf-8") as f:
+        text = f.read().replace("$\n", "")
+
+    for line in text.splitlines():
+        # Top-level variables such as $target_build_dir appear in paths
+        var = re.match(r"^([A-Za-z0-9_.-]+)\s*=\s*(.*)$", line)
+        if var:
+            variables[var.group(1)] = expand(var.group(2), variables)
+            continue
+        if not line.startswith("build "):
+            continue
+
+        # Split on unescaped ':' between outputs and rule
+        decl = line[len("build ") :]
+        i = 0
+        while True:
+            i = decl.index(":", i)
+            if i == 0 or decl[i - 1] != "$":
+                break
+            i += 1
+
+        outputs = split_paths(decl[:i], variables)
+        rest = split_paths(decl[i + 1 :], variables)
+        rule, deps = rest[0], rest[1:]
+        if "||" in deps:
+            deps = deps[: deps.index("||")]
+        inputs = [d for d in deps if d != "|"]
+        for output in outputs:
+            if output == "|":
+                continue
+            graph[output] = Edge(rule, inputs)
+    return graph
+
+
+def expand(text: str, variables: Dict[str, str]) -> str:
+    def lookup(m: Match[str]) -> str:
+        name = m.group(1) or m.group(2)
+        if name is None:
+            return m.group(0)[1:]  # Escaped character
+        return variables.get(name, "")
+
+    return re.sub(r"\$\{([A-Za-z0-9_.-]+)\}|\$([A-Za-z0-9_-]+)|\$.", lookup, text)
+
+
+def split_paths(text: str, variables: Dict[str, str]) -> List[str]:
+    # Spaces escaped as '$ ' belong to the path
+    words = re.split(r"(?<!\$) +", text.strip())
+    return [expand(w, variables) for w in words if w]
+
+
+def critical_path(
+    entries: Dict[str, LogEntry], graph: Dict[str, Edge]
+) -> Tuple[int, List[str]]:
+    """Longest chain of dependent edges from the last build, by duration."""
+    memo: Dict[str, Tuple[int, Optional[str]]] = {}
+
+    def visit(output: str) -> int:
+        if output in memo:
+            return memo[output][0]
+        memo[output] = (0, None)  # Guard against cycles through phony edges
+
+        best, best_input = 0, None
+        edge = graph.get(output)
+        if edge is not None:
+            for input in edge.inputs:
+                cost = visit(input)
+                if cost > best:
+                    best, best_input = cost, input
+
+        entry = entries.get(output)
+        own = entry.duration if entry is not None else 0
+        memo[output] = (best + own, best_input)
+        return best + own
+
+    end, total = None, 0
+    for output in entries:
+        cost = visit(output)
+        if cost > total:
+            end, total = output, cost
+
+    path: List[str] = []
+    while end is not None:
+        if end in entries:
+            path.append(end)
+        end = memo[end][1]
+    path.reverse()
+    return total, path
+
+
+def union_time(intervals: List[Tuple[int, int]]) -> int:
+    """Time covered by at least one of the [start, end] intervals."""
+    total = 0
+    covered_to = None
+    for start, end in sorted(intervals):
+        if covered_to is None or start > covered_to:
+            total += end - start
+            covered_to = end
+        elif end > covered_to:
+            total += end - covered_to
+            covered_to = end
+    return total
+
+
+def git_revision() -> str:
+    try:
+        return subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"],
+            capture_output=True,
+            check=True,
+            text=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("ninja_file", help="build.ninja written by configure.py")
+    parser.add_argument("ninja_log", help=".ninja_log of the build to summarize")
+    parser.add_argument("--history", help="JSON lines file to append a summary to")
+    parser.add_argument("--top", type=int, default=10, help="slowest outputs to list")
+    parser.add_argument(
+        "--ignore",
+        action="append",
+        default=[],
+        help="outputs to leave out, such as the edge running this script",
+    )
+    args = parser.parse_args()
+
+    if not os.path.exists(args.ninja_log):
+        print(f"{args.ninja_log} not found, run a build first")
+        return
+
+    graph = read_build_graph(args.ninja_file)
+    log = read_ninja_log(args.ninja_log, set(args.ignore))
+    entries = {e.output: e for e in log}
+    if not entries:
+        print("No build recorded")
+        return
+
+    wall = max(e.end for e in log) - min(e.start for e in log)
+    cp_total, cp_path = critical_path(entries, graph)
+
+    def phase_of(output: str) -> str:
+        edge = graph.get(output)
+        rule = edge.rule if edge is not None else "unknown"
+        return PHASES.get(rule, rule)
+
+    phases: Dict[str, Dict[str, int]] = {}
+    intervals: Dict[str, List[Tuple[int, int]]] = {}
+    for e in log:
+        phase = phases.setdefault(phase_of(e.output), {"edges": 0, "time": 0, "wall": 0, "critical": 0})
+        phase["edges"] += 1
+        phase["time"] += e.duration
+        intervals.setdefault(phase_of(e.output), []).append((e.start, e.end))
+    for name, spans in intervals.items():
+        phases[name]["wall"] = union_time(spans)
+    for output in cp_path:
+        phases[phase_of(output)]["critical"] += entries[output].duration
+
+    print(f"Wall time:     {wall / 1000:8.3f}s")
+    print(f"Critical path: {cp_total / 1000:8.3f}s over {len(cp_path)} edges")
+    print()
+    print(f"{'phase':<12}{'edges':>6}{'summed':>11}{'wall':>11}{'critical':>11}")
+    for name, phase in sorted(phases.items(), key=lambda p: -p[1]["wall"]):
+        print(
+            f"{name:<12}{phase['edges']:>6}{phase['time'] / 1000:>10.3f}s"
+            f"{phase['wall'] / 1000:>10.3f}s{phase['critical'] / 1000:>10.3f}s"
+        )
+
+    print()
+    print("Critical path:")
+    for output in cp_path:
+        print(f"  {entries[output].duration / 1000:8.3f}s  {output}")
+
+    print()
+    print(f"Slowest {args.top} outputs:")
+    for e in sorted(log, key=lambda e: -e.duration)[: args.top]:
+        print(f"  {e.duration / 1000:8.3f}s  {phase_of(e.output):<8}  {e.output}")
+
+    if args.history:
+        record = {
+            "time": int(time.time()),
+            "revision": git_revision(),
+            "wall_ms": wall,
+            "critical_ms": cp_total,
+            "phases": phases,
+            "outputs": {e.output: e.duration for e in log},
+        }
+        with open(args.history, "a", encoding="utf-8") as f:
+            f.write(json.dumps(record, sort_keys=True) + "\n")
+
+        with open(args.history, "r", encoding="utf-8") as f:
+            history = [json.loads(line) for line in f if line.strip()]
+        if len(history) > 1:
+            prev = history[-2]
+            delta = wall - prev["wall_ms"]
+            print()
+            print(
+                f"Wall time vs {prev['revision']}: {delta / 1000:+.3f}s "
+                f"({delta * 100 / max(prev['wall_ms'], 1):+.1f}%)"
+            )
+
+
+if __name__ == "__main__":
+    main()
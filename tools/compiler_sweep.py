@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+
+###
+# Identifies the compiler version that best matches a target object.
+#
+# Compiles a unit's source with every installed COMPILER_MAP version in
+# parallel, caching objects between runs, and ranks the versions by how well
+# their output matches the target object.
+#
+# Usage:
+#   python3 tools/compiler_sweep.py main_content/01_abi_basics.c
+#   python3 tools/compiler_sweep.py main_content/01_abi_basics.c --target other.o --source target
+###
+
+import argparse
+import os
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import mwcc
+from elffile import ElfFile, object_score
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("unit", help="BuildObject path, e.g. main_content/01_abi_basics.c")
+    parser.add_argument("--target", help="object to match (default: the unit's target object)")
+    parser.add_argument(
+        "--source",
+        choices=("base", "target"),
+        default="base",
+        help="which source of the unit to compile",
+    )
+    parser.add_argument("--versions", help="comma separated subset of COMPILER_MAP")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--cache", type=Path, default=mwcc.configure.build_dir / "sweep")
+    parser.add_argument("--top", type=int, default=10, help="versions to list")
+    parser.add_argument("-v", "--verbose", action="store_true", help="show per-function ratios")
+    args = parser.parse_args()
+
+    build_object = mwcc.find_build_object(args.unit)
+    if args.source == "base":
+        source = os.path.join("src", build_object.base_path)
+        flags = mwcc.configure.BASE_MWCC_FLAGS
+    else:
+        source = os.path.join("src", build_object.target_path)
+        flags = mwcc.configure.TARGET_MWCC_FLAGS
+    target = args.target or os.path.join(mwcc.configure.target_build_dir, build_object.target_obj)
+    if not os.path.exists(target):
+        sys.exit(f"{target} not found, build it with ninja first")
+
+    versions = mwcc.installed_versions()
+    if args.versions:
+        wanted = args.versions.split(",")
+        versions = [v for v in wanted if v in versions]
+    if not versions:
+        sys.exit("No compilers found, run `ninja tools` first")
+
+    target_funcs = ElfFile.read(target).functions()
+    with open(source, "rb") as f:
+        source_text = f.read()
+    cache = mwcc.CompileCache(args.cache, flags)
+
+    def sweep(version: str) -> Tuple[str, Optional[float], Dict[str, float], str]:
+        obj, log = cache.compile(version, flags, source_text, source)
+        if obj is None:
+            return version, None, {}, log
+        score, ratios = object_score(target_funcs, ElfFile.read(str(obj)).functions())
+        return version, score, ratios, log
+
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = list(pool.map(sweep, versions))
+
+    ranked = sorted((r for r in results if r[1] is not None), key=lambda r: -r[1])
+    failed = [r for r in results if r[1] is None]
+
+    print(f"{source} against {target}, {len(versions)} compilers")
+    print(f"{'version':<16}{'score':>8}{'matched':>10}")
+    for version, score, ratios, _ in ranked[: args.top]:
+        matched = sum(1 for r in ratios.values() if r == 1.0)
+        print(f"{version:<16}{score * 100:>7.2f}%{matched:>6}/{len(ratios):<3}")
+        if args.verbose:
+            for name, ratio in sorted(ratios.items()):
+                print(f"    {ratio * 100:6.2f}%  {name}")
+
+    # Versions that produced identical scores are indistinguishable for this unit
+    if len(ranked) > 1 and ranked[0][1] == ranked[1][1]:
+        tied = [r[0] for r in ranked if r[1] == ranked[0][1]]
+        print(f"Tied for best: {', '.join(tied)}")
+
+    for version, _, _, log in failed:
+        print(f"{version}: compile failed")
+        if args.verbose:
+            print(log)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,176 @@
+###
+# Minimal reader for the big-endian ELF32 files mwcc and mwld produce.
+#
+# Provides sections, symbols and relocations, and extracts functions as
+# instruction tokens with relocated fields masked so objects can be compared
+# independently of where their references ended up.
+###
+
+import difflib
+import struct
+from typing import Dict, List, NamedTuple, Optional, Tuple
+
+SHT_SYMTAB = 2
+SHT_RELA = 4
+SHT_NOBITS = 8
+
+STT_OBJECT = 1
+STT_FUNC = 2
+STT_SECTION = 3
+
+SHF_EXECINSTR = 0x4
+
+# Bits of an instruction word each PPC relocation type rewrites
+RELOC_MASKS: Dict[int, int] = {
+    1: 0xFFFFFFFF,  # R_PPC_ADDR32
+    4: 0x0000FFFF,  # R_PPC_ADDR16_LO
+    5: 0x0000FFFF,  # R_PPC_ADDR16_HI
+    6: 0x0000FFFF,  # R_PPC_ADDR16_HA
+    10: 0x03FFFFFC,  # R_PPC_REL24
+    11: 0x0000FFFC,  # R_PPC_REL14
+    109: 0x001FFFFF,  # R_PPC_EMB_SDA21
+}
+
+
+class Section(NamedTuple):
+    index: int
+    name: str
+    type: int
+    flags: int
+    addr: int
+    offset: int
+    size: int
+    link: int
+    info: int
+    entsize: int
+
+
+class Symbol(NamedTuple):
+    name: str
+    value: int
+    size: int
+    type: int
+    bind: int
+    shndx: int
+
+
+class Reloc(NamedTuple):
+    offset: int
+    type: int
+    symbol: int
+    addend: int
+
+
+class Function(NamedTuple):
+    name: str
+    section: str
+    address: int
+    code: bytes
+    # One (masked word, relocation target) pair per instruction
+    tokens: List[Tuple[int, Optional[str]]]
+
+
+class ElfFile:
+    def __init__(self, data: bytes) -> None:
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 2:
+            raise ValueError("not a big-endian ELF32 file")
+        self.data = data
+
+        (shoff,) = struct.unpack_from(">I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(">3H", data, 0x2E)
+        (self.entry,) = struct.unpack_from(">I", data, 0x18)
+
+        raw = [struct.unpack_from(">10I", data, shoff + i * shentsize) for i in range(shnum)]
+        names = raw[shstrndx] if shstrndx < shnum else None
+        self.sections: List[Section] = []
+        for i, (name, type, flags, addr, offset, size, link, info, _, entsize) in enumerate(raw):
+            sec_name = self._string(names[4], name) if names else ""
+            self.sections.append(Section(i, sec_name, type, flags, addr, offset, size, link, info, entsize))
+
+        self.symbols: List[Symbol] = []
+        self.relocs: Dict[int, List[Reloc]] = {}
+        for sec in self.sections:
+            if sec.type == SHT_SYMTAB:
+                strtab = self.sections[sec.link]
+                for off in range(sec.offset, sec.offset + sec.size, 16):
+                    name, value, size, info, _, shndx = struct.unpack_from(">3I2BH", data, off)
+                    self.symbols.append(
+                        Symbol(self._string(strtab.offset, name), value, size, info & 0xF, info >> 4, shndx)
+                    )
+            elif sec.type == SHT_RELA:
+                relocs = self.relocs.setdefault(sec.info, [])
+                for off in range(sec.offset, sec.offset + sec.size, 12):
+                    r_offset, r_info, r_addend = struct.unpack_from(">IIi", data, off)
+                    relocs.append(Reloc(r_offset, r_info & 0xFF, r_info >> 8, r_addend))
+
+    @classmethod
+    def read(cls, path: str) -> "ElfFile":
+        with open(path, "rb") as f:
+            return cls(f.read())
+
+    def _string(self, offset: int, index: int) -> str:
+        end = self.data.index(b"\0", offset + index)
+        return self.data[offset + index : end].decode("ascii", "replace")
+
+    def section_data(self, sec: Section) -> bytes:
+        if sec.type == SHT_NOBITS:
+            return bytes(sec.size)
+        return self.data[sec.offset : sec.offset + sec.size]
+
+    def section_by_name(self, name: str) -> Optional[Section]:
+        for sec in self.sections:
+            if sec.name == name:
+                return sec
+        return None
+
+    def reloc_target(self, reloc: Reloc) -> str:
+        sym = self.symbols[reloc.symbol]
+        if sym.type == STT_SECTION or not sym.name or sym.name.startswith("@"):
+            # Compiler-generated locals are numbered per TU, name the section
+            return self.sections[sym.shndx].name if sym.shndx < len(self.sections) else "?"
+        return sym.name
+
+    def functions(self) -> Dict[str, Function]:
+        """Functions by name, with relocated instruction fields masked."""
+        result: Dict[str, Function] = {}
+        for sym in self.symbols:
+            if sym.type != STT_FUNC or sym.shndx == 0 or sym.shndx >= len(self.sections):
+                continue
+            sec = self.sections[sym.shndx]
+            data = self.section_data(sec)
+            # Objects store section-relative values, linked files addresses
+            start = sym.value - sec.addr if sym.value >= sec.addr else sym.value
+            code = data[start : start + sym.size]
+
+            words = [w for (w,) in struct.iter_unpack(">I", code[: len(code) & ~3])]
+            targets: List[Optional[str]] = [None] * len(words)
+            for reloc in self.relocs.get(sec.index, []):
+                rel = reloc.offset - sec.addr if reloc.offset >= sec.addr else reloc.offset
+                i = (rel - start) >> 2
+                if 0 <= rel - start < len(code) and i < len(words):
+                    words[i] &= ~RELOC_MASKS.get(reloc.type, 0xFFFFFFFF) & 0xFFFFFFFF
+                    targets[i] = self.reloc_target(reloc)
+
+            result[sym.name] = Function(sym.name, sec.name, sym.value, code, list(zip(words, targets)))
+        return result
+
+
+def function_ratio(target: Function, candidate: Optional[Function]) -> float:
+    """Similarity of two functions in [0, 1], 1 meaning a match."""
+    if candidate is None:
+        return 0.0
+    if target.tokens == candidate.tokens:
+        return 1.0
+    return difflib.SequenceMatcher(None, target.tokens, candidate.tokens, autojunk=False).ratio()
+
+
+def object_score(
+    target: Dict[str, Function], candidate: Dict[str, Function]
+) -> Tuple[float, Dict[str, float]]:
+    """Size-weighted match of every target function, and the per-function ratios."""
+    ratios = {name: function_ratio(func, candidate.get(name)) for name, func in target.items()}
+    total = sum(len(f.code) for f in target.values())
+    if total == 0:
+        return 1.0, ratios
+    score = sum(ratios[name] * len(func.code) for name, func in target.items()) / total
+    return score, ratios
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+
+###
+# Fingerprint index of every compiled function, to find functions that
+# were already solved somewhere else.
+#
+# Each function gets two exact hashes and a fuzzy signature:
+#   - masked: instruction words with relocated fields cleared, so functions
+#     that only differ in what they reference hash the same
+#   - full: masked words plus relocation targets
+#   - minhash: MinHash over opcode trigrams, ignoring registers and
+#     immediates, which estimates how similar two functions' shapes are
+#
+# The index (build/fingerprint.idx by default) is a compact binary file.
+# `update` only re-reads objects whose size or mtime changed, and
+# `ninja fingerprint` runs it over every target and base object.
+#
+# Usage:
+#   python3 tools/fingerprint.py update [objects...]
+#   python3 tools/fingerprint.py lookup weird_func
+#   python3 tools/fingerprint.py lookup build/src/base/foo.o:bar --threshold 0.5
+#   python3 tools/fingerprint.py dups
+###
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, Iterable, List, NamedTuple, Optional, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import mwcc
+from elffile import ElfFile, Function
+
+INDEX_MAGIC = b"FPIX"
+INDEX_VERSION = 1
+
+MINHASH_SIZE = 32
+NGRAM = 3
+MERSENNE_61 = (1 << 61) - 1
+
+HEADER = struct.Struct("<4s5I")
+OBJECT = struct.Struct("<2IQI")
+ENTRY = struct.Struct(f"<3I2Q{MINHASH_SIZE}I")
+
+
+def _permutations() -> List[Tuple[int, int]]:
+    """Fixed (a, b) pairs for the universal hashes, derived so every index agrees."""
+    result = []
+    for i in range(MINHASH_SIZE):
+        digest = hashlib.blake2b(f"minhash{i}".encode(), digest_size=16).digest()
+        a, b = struct.unpack("<2Q", digest)
+        result.append((a % (MERSENNE_61 - 1) + 1, b % MERSENNE_61))
+    return result
+
+
+PERMUTATIONS = _permutations()
+
+
+class Entry(NamedTuple):
+    object: int
+    name: int
+    size: int
+    masked: int
+    full: int
+    minhash: Tuple[int, ...]
+
+
+class IndexedObject(NamedTuple):
+    path: str
+    source: str
+    mtime_ns: int
+    size: int
+
+
+class Index:
+    def __init__(self) -> None:
+        self.strings: List[str] = []
+        self.string_ids: Dict[str, int] = {}
+        self.objects: List[IndexedObject] = []
+        self.entries: List[Entry] = []
+
+    def intern(self, s: str) -> int:
+        if s not in self.string_ids:
+            self.string_ids[s] = len(self.strings)
+            self.strings.append(s)
+        return self.string_ids[s]
+
+    @classmethod
+    def read(cls, path: Path) -> "Index":
+        index = cls()
+        if not path.exists():
+            return index
+        data = path.read_bytes()
+        magic, version, minhash_size, num_strings, num_objects, num_entries = HEADER.unpack_from(data, 0)
+        if magic != INDEX_MAGIC or version != INDEX_VERSION or minhash_size != MINHASH_SIZE:
+            # Stale format, rebuild from scratch
+            return index
+
+        offset = HEADER.size
+        for _ in range(num_strings):
+            (length,) = struct.unpack_from("<H", data, offset)
+            index.intern(data[offset + 2 : offset + 2 + length].decode("utf-8"))
+            offset += 2 + length
+        for _ in range(num_objects):
+            path_id, source_id, mtime_ns, size = OBJECT.unpack_from(data, offset)
+            index.objects.append(IndexedObject(index.strings[path_id], index.strings[source_id], mtime_ns, size))
+            offset += OBJECT.size
+        for _ in range(num_entries):
+            obj, name, size, masked, full, *minhash = ENTRY.unpack_from(data, offset)
+            index.entries.append(Entry(obj, name, size, masked, full, tuple(minhash)))
+            offset += ENTRY.size
+        return index
+
+    def write(self, path: Path) -> None:
+        # Only strings still referenced are kept
+        strings = Index()
+        objects = [
+            OBJECT.pack(strings.intern(o.path), strings.intern(o.source), o.mtime_ns, o.size) for o in self.objects
+        ]
+        entries = [
+            ENTRY.pack(e.object, strings.intern(self.strings[e.name]), e.size, e.masked, e.full, *e.minhash)
+            for e in self.entries
+        ]
+        out = [HEADER.pack(INDEX_MAGIC, INDEX_VERSION, MINHASH_SIZE, len(strings.strings), len(objects), len(entries))]
+        for s in strings.strings:
+            encoded = s.encode("utf-8")
+            out.append(struct.pack("<H", len(encoded)) + encoded)
+        out += objects + entries
+
+        path.parent.mkdir(parents=True, exist_ok=True)
+        tmp = path.with_suffix(".tmp")
+        tmp.write_bytes(b"".join(out))
+        os.replace(tmp, path)
+
+
+def opcode(word: int) -> int:
+    """Primary and extended opcode of an instruction, without register or immediate fields."""
+    primary = word >> 26
+    if primary in (19, 31):
+        return primary << 16 | (word >> 1) & 0x3FF
+    if primary == 59 or (primary == 63 and word & 0x20):
+        return primary << 16 | (word >> 1) & 0x1F
+    if primary in (4, 63):
+        return primary << 16 | (word >> 1) & 0x3FF
+    return primary << 16
+
+
+def fingerprint(func: Function) -> Tuple[int, int, Tuple[int, ...]]:
+    words = b"".join(struct.pack(">I", w) for w, _ in func.tokens)
+    masked = hashlib.blake2b(words, digest_size=8).digest()
+    targets = "\0".join(t or "" for _, t in func.tokens).encode()
+    full = hashlib.blake2b(words + b"\0" + targets, digest_size=8).digest()
+
+    ops = [opcode(w) for w, _ in func.tokens]
+    grams = {tuple(ops[i : i + NGRAM]) for i in range(max(1, len(ops) - NGRAM + 1))}
+    hashes = [
+        int.from_bytes(hashlib.blake2b(struct.pack(f">{len(g)}I", *g), digest_size=8).digest(), "little")
+        for g in grams
+    ]
+    minhash = tuple(min(((a * h + b) % MERSENNE_61) & 0xFFFFFFFF for h in hashes) for a, b in PERMUTATIONS)
+    return int.from_bytes(masked, "little"), int.from_bytes(full, "little"), minhash
+
+
+def similarity(a: Entry, b: Entry) -> float:
+    """Estimated Jaccard similarity of the opcode trigram sets."""
+    return sum(1 for x, y in zip(a.minhash, b.minhash) if x == y) / MINHASH_SIZE
+
+
+def source_paths() -> Dict[str, str]:
+    """Object path -> source path for every object configure.py builds."""
+    result: Dict[str, str] = {}
+    conf = mwcc.configure
+    objects = conf.build_objects + conf.bench_objects + conf.profile_objects + [conf.rel_module_object, conf.rel_loader_object]
+    for build_dir in (conf.target_build_dir, conf.base_build_dir, conf.bench_build_dir, conf.profile_build_dir):
+        for o in objects:
+            for path in (o.target_path, o.base_path):
+                obj = os.path.join(build_dir, os.path.splitext(path)[0] + ".o")
+                result[os.path.normpath(obj)] = os.path.join("src", path)
+    return result
+
+
+def default_objects() -> List[str]:
+    conf = mwcc.configure
+    objects = []
+    for o in conf.build_objects:
+        objects.append(os.path.join(conf.target_build_dir, o.target_obj))
+        objects.append(os.path.join(conf.base_build_dir, o.base_obj))
+    return [p for p in objects if os.path.exists(p)]
+
+
+def update(index: Index, objects: Iterable[str]) -> Tuple[int, int]:
+    """Brings the index in line with objects, returns (objects read, functions indexed)."""
+    sources = source_paths()
+    old = {o.path: (i, o) for i, o in enumerate(index.objects)}
+    by_object: Dict[int, List[Entry]] = {}
+    for e in index.entries:
+        by_object.setdefault(e.object, []).append(e)
+
+    new_objects: List[IndexedObject] = []
+    new_entries: List[Entry] = []
+    read = 0
+    for path in objects:
+        path = os.path.normpath(path)
+        st = os.stat(path)
+        obj_id = len(new_objects)
+        prev = old.get(path)
+        if prev and prev[1].mtime_ns == st.st_mtime_ns and prev[1].size == st.st_size:
+            new_objects.append(prev[1])
+            new_entries += [e._replace(object=obj_id) for e in by_object.get(prev[0], [])]
+            continue
+
+        read += 1
+        new_objects.append(IndexedObject(path, sources.get(path, ""), st.st_mtime_ns, st.st_size))
+        for func in ElfFile.read(path).functions().values():
+            if not func.tokens:
+                continue
+            masked, full, minhash = fingerprint(func)
+            new_entries.append(Entry(obj_id, index.intern(func.name), len(func.code), masked, full, minhash))
+
+    index.objects = new_objects
+    index.entries = new_entries
+    return read, len(new_entries)
+
+
+def describe(index: Index, e: Entry) -> str:
+    obj = index.objects[e.object]
+    return f"{obj.source or obj.path}:{index.strings[e.name]}"
+
+
+def find_queries(index: Index, query: str) -> List[Entry]:
+    """Entries for `name` or `object.o:name`, reading the object if it isn't indexed."""
+    path, _, name = query.rpartition(":")
+    if not path:
+        return [e for e in index.entries if index.strings[e.name] == name]
+
+    path = os.path.normpath(path)
+    for i, o in enumerate(index.objects):
+        if o.path == path:
+            return [e for e in index.entries if e.object == i and index.strings[e.name] == name]
+    func = ElfFile.read(path).functions().get(name)
+    if func is None:
+        return []
+    masked, full, minhash = fingerprint(func)
+    index.objects.append(IndexedObject(path, source_paths().get(path, ""), 0, 0))
+    return [Entry(len(index.objects) - 1, index.intern(name), len(func.code), masked, full, minhash)]
+
+
+def lookup(index: Index, query: Entry, threshold: float, top: int) -> None:
+    print(f"{describe(index, query)} ({query.size:#x} bytes)")
+    matches: List[Tuple[float, int, str, Entry]] = []
+    for e in index.entries:
+        if e == query or (e.object == query.object and e.name == query.name):
+            continue
+        if e.masked == query.masked:
+            kind = "identical" if e.full == query.full else "relocs differ"
+            matches.append((2.0, 0, kind, e))
+            continue
+        score = similarity(query, e)
+        if score >= threshold:
+            matches.append((score, abs(e.size - query.size), f"{score * 100:.0f}% similar", e))
+
+    matches.sort(key=lambda m: (-m[0], m[1]))
+    for _, _, kind, e in matches[:top]:
+        print(f"    {kind:<16}{describe(index, e)} ({e.size:#x} bytes)")
+    if not matches:
+        print("    no matches")
+
+
+def dups(index: Index) -> None:
+    """Groups of functions that are identical modulo relocations, across different sources."""
+    groups: Dict[int, List[Entry]] = {}
+    for e in index.entries:
+        groups.setdefault(e.masked, []).append(e)
+    for entries in sorted(groups.values(), key=lambda g: -g[0].size):
+        names = {describe(index, e) for e in entries}
+        if len(names) < 2:
+            continue
+        print(f"{entries[0].size:#x} bytes")
+        for name in sorted(names):
+            print(f"    {name}")
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--index", type=Path, default=mwcc.configure.build_dir / "fingerprint.idx")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_update = sub.add_parser("update", help="index objects (default: every target and base object)")
+    p_update.add_argument("objects", nargs="*")
+    p_lookup = sub.add_parser("lookup", help="list functions matching a function")
+    p_lookup.add_argument("function", help="name, or object.o:name")
+    p_lookup.add_argument("--threshold", type=float, default=0.6, help="minimum fuzzy similarity")
+    p_lookup.add_argument("--top", type=int, default=20)
+    sub.add_parser("dups", help="list functions identical modulo relocations")
+    args = parser.parse_args()
+
+    index = Index.read(args.index)
+    if args.command == "update":
+        read, count = update(index, args.objects or default_objects())
+        index.write(args.index)
+        print(f"{args.index}: {count} functions in {len(index.objects)} objects ({read} re-read)")
+    elif args.command == "lookup":
+        queries = find_queries(index, args.function)
+        if not queries:
+            sys.exit(f"{args.function} not found, run `update` or pass object.o:name")
+        for query in queries:
+            lookup(index, query, args.threshold, args.top)
+    else:
+        dups(index)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+
+###
+# Differential fuzzer for training_answers against training_template.
+#
+# A function can match byte for byte and still be wrong, or not match and
+# still be correct. This compiles each unit's answers and template sources
+# natively into two shared objects, which src/native/fuzz_main.c loads
+# side by side with their own symbol namespaces. It calls every function
+# the answers define on both with the same generated arguments. Pointer
+# arguments get arrays with guard bytes, and globals are set before each
+# call and compared after it. Iteration ranges are spread across cores.
+#
+# The first divergence per function is reported with minimized inputs.
+# Only scalar and pointer-to-scalar signatures are supported. The host's
+# semantics apply, so integer division by zero traps.
+#
+# Usage:
+#   python3 tools/fuzz.py main_content/00_basic_assembly_and_isa.c -n 10000000
+#   python3 tools/fuzz.py --tree submissions/alice/main_content --json fuzz.json
+###
+
+import argparse
+import json
+import os
+import re
+import signal
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Any, Dict, List, NamedTuple, Optional, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import mwcc
+from mwcc import BuildObject
+
+INT_WORDS = {"signed", "unsigned", "int", "char", "short", "long"}
+INT_TYPEDEFS = {"s8", "s16", "s32", "s64", "u8", "u16", "u32", "u64", "BOOL", "size_t"}
+FLOAT_TYPES = {"float", "double", "f32", "f64"}
+QUALIFIERS = {"const", "volatile", "register"}
+
+
+class Param(NamedTuple):
+    name: str
+    base: str  # Scalar type without qualifiers or '*'
+    pointer: bool
+
+
+class Signature(NamedTuple):
+    name: str
+    ret: Optional[str]  # None for void
+    params: List[Param]
+
+
+def strip_source(source: str) -> Tuple[str, List[str]]:
+    """Top-level text without comments or preprocessor lines, with each body replaced by {index}."""
+    source = re.sub(r"//[^\n]*|/\*.*?\*/", " ", source, flags=re.S)
+    source = re.sub(r"^\s*#[^\n]*", "", source, flags=re.M)
+    out = []
+    bodies: List[str] = []
+    depth = 0
+    for c in source:
+        if c == "{":
+            if depth == 0:
+                out.append(f"{{{len(bodies)}}}")
+                bodies.append("")
+            else:
+                bodies[-1] += c
+            depth += 1
+        elif c == "}":
+            depth -= 1
+            if depth > 0:
+                bodies[-1] += c
+        elif depth == 0:
+            out.append(c)
+        else:
+            bodies[-1] += c
+    return "".join(out), bodies
+
+
+def scalar_type(text: str) -> Optional[str]:
+    """Normalized scalar type, or None if unsupported."""
+    words = [w for w in text.split() if w not in QUALIFIERS]
+    if not words:
+        return None
+    if len(words) == 1 and (words[0] in INT_TYPEDEFS or words[0] in FLOAT_TYPES):
+        return words[0]
+    if all(w in INT_WORDS for w in words):
+        return " ".join(words)
+    return None
+
+
+def parse_param(text: str) -> Optional[Param]:
+    m = re.fullmatch(r"\s*(.*?)\s*(\**)\s*([A-Za-z_]\w*)\s*", text)
+    if not m or len(m.group(2)) > 1:
+        return None
+    base = scalar_type(m.group(1))
+    if base is None:
+        return None
+    return Param(m.group(3), base, bool(m.group(2)))
+
+
+def parse_unit(source: str) -> Tuple[List[Signature], List[str], List[Tuple[str, str]]]:
+    """Fuzzable functions, unsupported function names and scalar globals of a source."""
+    text, bodies = strip_source(source)
+    functions: List[Signature] = []
+    unsupported: List[str] = []
+    for m in re.finditer(r"([A-Za-z_][\w\s]*?)\s*(\**)\s*\b([A-Za-z_]\w*)\s*\(([^()]*)\)\s*\{(\d+)\}", text):
+        words = m.group(1).split()
+        name = m.group(3)
+        if "static" in words:
+            continue
+        ret_text = " ".join(w for w in words if w not in ("extern", "inline"))
+        ret = None if ret_text == "void" and not m.group(2) else scalar_type(ret_text)
+        # Falling off the end leaves the return register undefined, e.g.
+        # `int store(int *a)` in chapter 0, so there is nothing to compare
+        if ret and not re.search(r"\breturn\b", bodies[int(m.group(5))]):
+            ret_text, ret = "void", None
+        params_text = m.group(4).strip()
+        params: List[Optional[Param]] = []
+        if params_text not in ("", "void"):
+            params = [parse_param(p) for p in params_text.split(",")]
+        if m.group(2) or (ret is None and ret_text != "void") or None in params:
+            unsupported.append(name)
+            continue
+        functions.append(Signature(name, ret, [p for p in params if p]))
+
+    globals_: List[Tuple[str, str]] = []
+    for m in re.finditer(r"(?:^|[;}])\s*([A-Za-z_][\w\s]*?)\s+([A-Za-z_]\w*)\s*(?:=[^;]*)?;", text):
+        words = m.group(1).split()
+        if "extern" in words or "static" in words or "typedef" in words:
+            continue
+        base = scalar_type(m.group(1))
+        if base:
+            globals_.append((m.group(2), base))
+    return functions, unsupported, globals_
+
+
+def kind(base: str) -> str:
+    if base in FLOAT_TYPES:
+        return f"FUZZ_KIND_FLOAT( {base} )"
+    return f"FUZZ_KIND( {base} )"
+
+
+def generate_cases(functions: List[Signature], globals_: List[Tuple[str, str]]) -> str:
+    """C source with a call thunk and FuzzCase per function, see src/native/fuzz.h."""
+    lines = [
+        "// Generated by tools/fuzz.py, do not edit",
+        "",
+        "#include \"fuzz.h\"",
+        "",
+    ]
+    for f in functions:
+        ret = f.ret or "void"
+        types = [p.base + (" *" if p.pointer else "") for p in f.params]
+        args = [f"({t})a[ {i} ]" if p.pointer else f"*({t} *)a[ {i} ]" for i, (t, p) in enumerate(zip(types, f.params))]
+        call = f"( ({ret} ( * )( {', '.join(types) or 'void'} ))fn )( {', '.join(args)} )".replace("(  )", "( )")
+        lines += [
+            f"static void call_{f.name}( void *fn, void **a, void *ret )",
+            "{",
+            f"    *({ret} *)ret = {call};" if f.ret else f"    {call};",
+            "}",
+            "",
+        ]
+
+    lines.append("const FuzzCase fuzzCases[] = {")
+    for f in functions:
+        args = ", ".join(f"{{ \"{p.name}\", {kind(p.base)}, {int(p.pointer)} }}" for p in f.params) or "{ 0 }"
+        ret_kind = kind(f.ret) if f.ret else "0"
+        lines.append(f"    {{ \"{f.name}\", call_{f.name}, {ret_kind}, {len(f.params)}, {{ {args} }} }},")
+    if not functions:
+        lines.append("    { 0 },")
+    lines += [
+        "};",
+        f"const u32 fuzzNumCases = {len(functions)};",
+        "",
+        "const FuzzSlot fuzzGlobals[] = {",
+    ]
+    lines += [f"    {{ \"{name}\", {kind(base)}, 0 }}," for name, base in globals_] or ["    { 0 },"]
+    lines += [
+        "};",
+        f"const u32 fuzzNumGlobals = {len(globals_)};",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def run(cmd: List[str]) -> Tuple[bool, str]:
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return result.returncode == 0, result.stdout
+
+
+def build_side(source: Path, include_dir: Path, output: Path) -> Tuple[bool, str]:
+    cmd = [mwcc.configure.NATIVE_CC, "-O1", "-g", "-w", "-fno-builtin", "-fPIC", "-shared"]
+    # Calls within a side must not bind to the other side's symbols
+    if sys.platform != "darwin":
+        cmd.append("-Wl,-Bsymbolic")
+    cmd += ["-Isrc/shared", f"-I{include_dir}", str(source), "src/shared/stuff.c", "-o", str(output)]
+    return run(cmd)
+
+
+def build_driver(cases: Path, output: Path) -> Tuple[bool, str]:
+    cmd = [mwcc.configure.NATIVE_CC, "-O2", "-g", "-Isrc/runtime", "-Isrc/native"]
+    cmd += ["src/native/fuzz_main.c", str(cases), "-o", str(output), "-ldl"]
+    return run(cmd)
+
+
+def fuzz_unit(unit: BuildObject, args: argparse.Namespace) -> Dict[str, Any]:
+    answers = Path("src", unit.target_path)
+    template = Path("src", unit.base_path)
+    if args.tree:
+        template = args.tree / os.path.relpath(unit.base_path, os.path.join(mwcc.configure.base_src_dir, "main_content"))
+    if not template.is_file():
+        return {"status": "missing", "log": f"{template} not found"}
+
+    functions, unsupported, globals_ = parse_unit(answers.read_text(encoding="utf-8"))
+    if args.functions:
+        functions = [f for f in functions if f.name in args.functions]
+
+    out_dir = mwcc.configure.build_dir / "fuzz" / unit.name
+    out_dir.mkdir(parents=True, exist_ok=True)
+    cases = out_dir / "cases.c"
+    cases.write_text(generate_cases(functions, globals_), encoding="utf-8")
+
+    steps = [
+        build_side(answers, answers.parent, out_dir / "answers.so"),
+        build_side(template, template.parent, out_dir / "template.so"),
+        build_driver(cases, out_dir / "fuzz"),
+    ]
+    for ok, log in steps:
+        if not ok:
+            return {"status": "failed", "log": log}
+
+    # Contiguous ranges per worker, the earliest divergence wins
+    jobs = max(1, min(args.jobs, args.iterations))
+    chunk = -(-args.iterations // jobs)
+    ranges = [(start, min(chunk, args.iterations - start)) for start in range(0, args.iterations, chunk)]
+
+    def worker(r: Tuple[int, int]) -> List[Dict[str, Any]]:
+        cmd = [str(out_dir / "fuzz"), str(out_dir / "answers.so"), str(out_dir / "template.so")]
+        cmd += ["--seed", str(args.seed), "--start", str(r[0]), "--count", str(r[1])]
+        ok, log = run(cmd)
+        if not ok:
+            raise SystemExit(f"{unit.file_path}: fuzz driver failed\n{log}")
+        return [json.loads(line) for line in log.splitlines() if line.startswith("{")]
+
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        chunks = list(pool.map(worker, ranges))
+
+    results: Dict[str, Dict[str, Any]] = {}
+    for lines in chunks:
+        for r in lines:
+            best = results.get(r["function"])
+            if r["status"] == "ok":
+                if best is None:
+                    results[r["function"]] = r
+                elif best["status"] == "ok":
+                    best["iterations"] += r["iterations"]
+            elif r["status"] == "missing":
+                results[r["function"]] = r
+            elif best is None or best["status"] == "ok" or r["iteration"] < best.get("iteration", 1 << 64):
+                results[r["function"]] = r
+    for name in unsupported:
+        results[name] = {"function": name, "status": "unsupported"}
+    return {"status": "ok", "functions": results}
+
+
+def format_values(values: Dict[str, Any]) -> str:
+    parts = []
+    for name, value in values.items():
+        if isinstance(value, list):
+            # Trailing zeros of pointer arrays are noise after minimizing
+            while len(value) > 1 and value[-1] == 0:
+                value = value[:-1]
+            value = "[" + ", ".join(str(v) for v in value) + ", ...]"
+        parts.append(f"{name}={value}")
+    return ", ".join(parts)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("units", nargs="*", help="BuildObject paths (default: every diffed unit)")
+    parser.add_argument("-n", "--iterations", type=int, default=1 << 20, help="inputs per function")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--functions", help="comma separated subset of functions")
+    parser.add_argument("--tree", type=Path, help="main_content directory to use instead of the template's")
+    parser.add_argument("--json", help="also write results to this file")
+    parser.add_argument("-v", "--verbose", action="store_true", help="print compiler errors")
+    args = parser.parse_args()
+    if args.functions:
+        args.functions = set(args.functions.split(","))
+
+    units: List[BuildObject] = [o for o in mwcc.configure.build_objects if o.should_diff]
+    if args.units:
+        units = [mwcc.find_build_object(u) for u in args.units]
+
+    report: Dict[str, Any] = {}
+    diverged = False
+    for unit in units:
+        result = fuzz_unit(unit, args)
+        report[unit.file_path] = result
+        print(f"{unit.file_path}:")
+        if result["status"] != "ok":
+            print(f"    {result['status']}")
+            if args.verbose:
+                print(result["log"])
+            continue
+
+        for name, r in result["functions"].items():
+            status = r["status"]
+            if status == "ok":
+                print(f"    {name:<32}ok ({r['iterations']} inputs)")
+            elif status == "missing":
+                print(f"    {name:<32}missing from {r['side']}")
+            elif status == "unsupported":
+                print(f"    {name:<32}skipped, unsupported signature")
+            else:
+                diverged = True
+                print(f"    {name:<32}diverged at input {r['iteration']}")
+                print(f"        inputs:   {format_values(r['inputs'])}")
+                for side in ("answers", "template"):
+                    outcome = dict(r[side])
+                    trap = outcome.pop("trap")
+                    text = format_values(outcome)
+                    if trap:
+                        text = "timed out" if trap == signal.SIGALRM else f"trapped ({signal.Signals(trap).name})"
+                    print(f"        {side + ':':<10}{text}")
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=4)
+
+    sys.exit(1 if diverged else 0)
+
+
+if __name__ == "__main__":
+    main()
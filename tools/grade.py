@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+###
+# Grades a directory of student training_template trees against the answers.
+#
+# Each subdirectory of the submissions directory is one student and must
+# contain a main_content directory somewhere below it (a copy of
+# src/training_template works). The answer objects are compiled once, every
+# student's units are compiled in parallel through a shared compile cache, so
+# identical submissions only compile once, and each function is diffed
+# against the answer.
+#
+# Writes per-student, per-unit and per-function match percentages as CSV
+# and/or JSON.
+#
+# Usage:
+#   python3 tools/grade.py submissions/ --csv grades.csv --json grades.json
+###
+
+import argparse
+import csv
+import json
+import os
+import shlex
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Any, Dict, List, NamedTuple, Optional
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import mwcc
+from elffile import ElfFile, Function, object_score
+from mwcc import BuildObject
+
+
+class Result(NamedTuple):
+    student: str
+    unit: str
+    status: str  # ok, missing or failed
+    score: float
+    functions: Dict[str, float]
+    log: str
+
+
+def find_main_content(student: Path) -> Optional[Path]:
+    if (student / "main_content").is_dir():
+        return student / "main_content"
+    for root, dirs, _ in os.walk(student):
+        if "main_content" in dirs:
+            return Path(root) / "main_content"
+    return None
+
+
+def student_flags(main_content: Path) -> List[str]:
+    """BASE_MWCC_FLAGS with the template include path pointing at the student's tree."""
+    template = f"-Isrc/{mwcc.configure.base_src_dir}/main_content"
+    flags = [f for f in mwcc.configure.BASE_MWCC_FLAGS if f != template]
+    return flags + [f"-I{shlex.quote(str(main_content))}"]
+
+
+def unit_size(funcs: Dict[str, Function]) -> int:
+    return sum(len(f.code) for f in funcs.values())
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("submissions", type=Path, help="directory with one training_template tree per student")
+    parser.add_argument("--units", help="comma separated BuildObject paths (default: every diffed unit)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--cache", type=Path, default=mwcc.configure.build_dir / "grade")
+    parser.add_argument("--csv", help="write one row per student to this file")
+    parser.add_argument("--json", help="write per-function results to this file")
+    parser.add_argument("-v", "--verbose", action="store_true", help="print compiler errors")
+    args = parser.parse_args()
+
+    units: List[BuildObject] = [o for o in mwcc.configure.build_objects if o.should_diff]
+    if args.units:
+        units = [mwcc.find_build_object(u) for u in args.units.split(",")]
+
+    students = sorted(p for p in args.submissions.iterdir() if p.is_dir())
+    if not students:
+        sys.exit(f"No student directories in {args.submissions}")
+
+    # Answers, compiled once (and cached across runs)
+    target_flags = mwcc.configure.TARGET_MWCC_FLAGS
+    target_cache = mwcc.CompileCache(args.cache, target_flags)
+    targets: Dict[str, Dict[str, Function]] = {}
+    for unit in units:
+        source = os.path.join("src", unit.target_path)
+        with open(source, "rb") as f:
+            obj, log = target_cache.compile(unit.options["mw_version"], target_flags, f.read(), source)
+        if obj is None:
+            sys.exit(f"Answer {source} failed to compile:\n{log}")
+        targets[unit.file_path] = ElfFile.read(str(obj)).functions()
+
+    # One cache per student since the headers may differ, all sharing a directory.
+    # Keys cover header contents rather than tree paths, so identical trees share entries.
+    trees = {student: find_main_content(student) for student in students}
+    caches = {
+        student: mwcc.CompileCache(args.cache, student_flags(tree)) for student, tree in trees.items() if tree
+    }
+
+    def grade(student: Path, unit: BuildObject) -> Result:
+        target = targets[unit.file_path]
+        tree = trees[student]
+        name = os.path.relpath(unit.base_path, os.path.join(mwcc.configure.base_src_dir, "main_content"))
+        if tree is None or not (tree / name).is_file():
+            return Result(student.name, unit.file_path, "missing", 0.0, {n: 0.0 for n in target}, "")
+
+        source = tree / name
+        flags = student_flags(tree)
+        obj, log = caches[student].compile(unit.options["mw_version"], flags, source.read_bytes(), str(source))
+        if obj is None:
+            return Result(student.name, unit.file_path, "failed", 0.0, {n: 0.0 for n in target}, log)
+        score, ratios = object_score(target, ElfFile.read(str(obj)).functions())
+        return Result(student.name, unit.file_path, "ok", score, ratios, log)
+
+    tasks = [(student, unit) for student in students for unit in units]
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = list(pool.map(lambda t: grade(*t), tasks))
+
+    sizes = {u: unit_size(funcs) for u, funcs in targets.items()}
+    report: Dict[str, Dict[str, Any]] = {}
+    for r in results:
+        entry = report.setdefault(r.student, {"overall": 0.0, "units": {}})
+        entry["units"][r.unit] = {"status": r.status, "score": r.score, "functions": r.functions}
+        if args.verbose and r.status == "failed":
+            print(f"{r.student} {r.unit}:\n{r.log}")
+    total_size = sum(sizes.values()) or 1
+    for entry in report.values():
+        entry["overall"] = sum(u["score"] * sizes[name] for name, u in entry["units"].items()) / total_size
+
+    unit_names = [u.file_path for u in units]
+    print(f"{'student':<24}{'overall':>9}" + "".join(f"{os.path.basename(u):>28}" for u in unit_names))
+    for student, entry in report.items():
+        cells = []
+        for unit in unit_names:
+            u = entry["units"][unit]
+            cells.append(f"{u['score'] * 100:>27.2f}%" if u["status"] == "ok" else f"{u['status']:>28}")
+        print(f"{student:<24}{entry['overall'] * 100:>8.2f}%" + "".join(cells))
+
+    if args.csv:
+        columns = [(u, fn) for u in unit_names for fn in sorted(targets[u])]
+        with open(args.csv, "w", newline="", encoding="utf-8") as f:
+            writer = csv.writer(f)
+            writer.writerow(
+                ["student", "overall"] + unit_names + [f"{os.path.basename(u)}:{fn}" for u, fn in columns]
+            )
+            for student, entry in report.items():
+                row = [student, f"{entry['overall'] * 100:.2f}"]
+                row += [f"{entry['units'][u]['score'] * 100:.2f}" for u in unit_names]
+                row += [f"{entry['units'][u]['functions'][fn] * 100:.2f}" for u, fn in columns]
+                writer.writerow(row)
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=4)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,385 @@
+#!/usr/bin/env python3
+
+###
+# Parses MWLD link maps and reports section and symbol sizes.
+#
+# Reports per-section and per-symbol sizes, padding inserted by the ALIGN()
+# directives in the linker script and between object contributions, symbols that
+# were dead-stripped (-mapunused) and symbols that were linked even though
+# nothing in the closure from __start (-listclosure) references them.
+#
+# Results can be stored as a baseline, diffed against it and checked against
+# size budgets; the script exits non-zero when a budget is exceeded.
+#
+# Also locates tables and names addresses in memory dumps for the dump
+# readers (bench_results.py, mem_stats.py, profile_report.py, trace_decode.py).
+#
+# Usage:
+#   python3 tools/linkmap.py build/src/target/main.elf.MAP \
+#       --baseline build/sizes_baseline.json --budget .text=0x8000
+###
+
+import argparse
+import bisect
+import json
+import os
+import re
+import struct
+import sys
+from typing import Any, Dict, List, NamedTuple, Optional, Set, Tuple
+
+
+class Symbol(NamedTuple):
+    name: str
+    section: str
+    address: int
+    size: int
+    align: int
+    unit: str
+
+
+class Section(NamedTuple):
+    name: str
+    address: int
+    size: int
+
+
+class LinkMap(NamedTuple):
+    sections: List[Section]
+    symbols: List[Symbol]
+    unused: List[Symbol]
+    closure: Set[str]
+    linker_symbols: Dict[str, int]
+
+    def symbol(self, name: str) -> Optional[int]:
+        """Address of a symbol or linker generated symbol, if present."""
+        if name in self.linker_symbols:
+            return self.linker_symbols[name]
+        for sym in self.symbols:
+            if sym.name == name:
+                return sym.address
+        return None
+
+
+SECTION_LAYOUT = re.compile(r"^(\S+) section layout$")
+CLOSURE_ENTRY = re.compile(r"^\s*\d+\] (\S+) \(")
+MEMORY_ENTRY = re.compile(r"^\s+(\S+)\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})(?:\s|$)")
+LINKER_SYMBOL = re.compile(r"^\s+(\S+)\s+([0-9a-fA-F]{8})$")
+HEX = re.compile(r"^[0-9a-fA-F]+$")
+
+# Section alignment assumed when no linker script is given
+DEFAULT_ALIGN = 0x20
+
+
+def parse_map(path: str) -> LinkMap:
+    sections: List[Section] = []
+    symbols: List[Symbol] = []
+    unused: List[Symbol] = []
+    closure: Set[str] = set()
+    linker_symbols: Dict[str, int] = {}
+
+    state = None
+    section = ""
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            if not line.strip():
+                continue
+
+            if line.startswith("Link map of "):
+                state = "closure"
+                continue
+            m = SECTION_LAYOUT.match(line)
+            if m:
+                state, section = "layout", m.group(1)
+                continue
+            if line.startswith("Memory map:"):
+                state = "memory"
+                continue
+            if line.startswith("Linker generated symbols:"):
+                state = "linker"
+                continue
+
+            if state == "closure":
+                m = CLOSURE_ENTRY.match(line)
+                if m:
+                    closure.add(m.group(1))
+            elif state == "layout":
+                sym = parse_layout_line(line, section)
+                if sym is None:
+                    continue
+                if sym.address < 0:
+                    unused.append(sym)
+                else:
+                    symbols.append(sym)
+            elif state == "memory":
+                m = MEMORY_ENTRY.match(line)
+                # Debug and comment sections aren't loaded and sit at 0
+                if m and int(m.group(2), 16) != 0:
+                    sections.append(Section(m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+            elif state == "linker":
+                m = LINKER_SYMBOL.match(line)
+                if m:
+                    linker_symbols[m.group(1)] = int(m.group(2), 16)
+
+    sections.sort(key=lambda s: s.address)
+    return LinkMap(sections, symbols, unused, closure, linker_symbols)
+
+
+def parse_layout_line(line: str, section: str) -> Optional[Symbol]:
+    # "  00000000 000084 80003100  4 __start \truntime_core.o"; older linkers
+    # omit the alignment column, stripped symbols print UNUSED and dots.
+    fields, _, unit = line.partition("\t")
+    tokens = fields.split()
+    if len(tokens) < 4:
+        return None
+
+    if tokens[0] == "UNUSED":
+        if not HEX.match(tokens[1]):
+            return None
+        return Symbol(tokens[3], section, -1, int(tokens[1], 16), 0, unit.strip())
+
+    if not (HEX.match(tokens[0]) and HEX.match(tokens[1]) and HEX.match(tokens[2])):
+        return None
+    align = 0
+    if len(tokens) >= 5:
+        align = int(tokens[3])
+        name = tokens[4]
+    else:
+        name = tokens[3]
+    return Symbol(name, section, int(tokens[2], 16), int(tokens[1], 16), align, unit.strip())
+
+
+def find_in_dump(dump: bytes, base: int, link_map: Optional[LinkMap], symbol: str, magic: int, version: int, what: str) -> int:
+    """Offset of a table in a dump of memory starting at base.
+
+    Taken from the link map symbol when there is a map, otherwise the dump is
+    scanned for the table's magic and version words.
+    """
+    if link_map:
+        address = link_map.symbol(symbol)
+        if address is None:
+            sys.exit(f"{symbol} not found in the link map")
+        return address - base
+
+    offset = dump.find(struct.pack(">2I", magic, version))
+    if offset < 0:
+        sys.exit(f"{what} not found in dump")
+    return offset
+
+
+class DumpSymbols:
+    """Names addresses in a memory dump through the link map symbols."""
+
+    def __init__(self, dump: bytes, base: int, link_map: Optional[LinkMap]) -> None:
+        self.dump = dump
+        self.base = base
+        self.symbols = sorted(link_map.symbols, key=lambda s: s.address) if link_map else []
+        self.addresses = [s.address for s in self.symbols]
+
+    def containing(self, address: int) -> Optional[Symbol]:
+        i = bisect.bisect_right(self.addresses, address) - 1
+        if i < 0 or address - self.symbols[i].address >= max(self.symbols[i].size, 1):
+            return None
+        return self.symbols[i]
+
+    def symbol(self, address: int, exact: bool) -> Optional[str]:
+        """name or name+offset of the symbol containing address."""
+        sym = self.containing(address)
+        if sym is None or (exact and address != sym.address):
+            return None
+        offset = address - sym.address
+        return sym.name if offset == 0 else f"{sym.name}+{offset:#x}"
+
+    def string(self, address: int) -> Optional[str]:
+        """Printable NUL-terminated string at address."""
+        offset = address - self.base
+        if not 0 <= offset < len(self.dump):
+            return None
+        end = self.dump.find(b"\0", offset, offset + 256)
+        if end <= offset:
+            return None
+        text = self.dump[offset:end]
+        if not all(0x20 <= c < 0x7F for c in text):
+            return None
+        return text.decode("ascii")
+
+
+def read_lcf_alignment(path: str) -> Dict[str, int]:
+    """Section -> ALIGN() value from the GROUP in a linker script."""
+    result: Dict[str, int] = {}
+    with open(path, "r", encoding="utf-8") as f:
+        for m in re.finditer(r"(\S+)\s+ALIGN\((0x[0-9a-fA-F]+|\d+)\)", f.read()):
+            result[m.group(1)] = int(m.group(2), 0)
+    return result
+
+
+def analyze(link_map: LinkMap, lcf_align: Dict[str, int]) -> Dict[str, Any]:
+    sections: Dict[str, Any] = {}
+    ordered = link_map.sections
+    for i, sec in enumerate(ordered):
+        # The gap after the previous section is what this section's ALIGN()
+        # cost. Larger gaps are separate memory ranges, not padding.
+        padding = 0
+        if i > 0:
+            gap = sec.address - (ordered[i - 1].address + ordered[i - 1].size)
+            if 0 < gap < lcf_align.get(sec.name, DEFAULT_ALIGN):
+                padding = gap
+        sections[sec.name] = {
+            "address": sec.address,
+            "size": sec.size,
+            "align": lcf_align.get(sec.name, 0),
+            "align_padding": padding,
+            "object_padding": 0,
+        }
+
+    # Gaps between consecutive symbols inside a section
+    by_section: Dict[str, List[Symbol]] = {}
+    for sym in link_map.symbols:
+        by_section.setdefault(sym.section, []).append(sym)
+    for name, syms in by_section.items():
+        syms.sort(key=lambda s: (s.address, -s.size))
+        end = None
+        waste = 0
+        for sym in syms:
+            if end is not None and sym.address > end:
+                waste += sym.address - end
+            sym_end = sym.address + sym.size
+            end = sym_end if end is None else max(end, sym_end)
+        if name in sections:
+            sections[name]["object_padding"] = waste
+
+    # Section entries repeat the section name; keep real symbols only
+    symbols = {
+        f"{s.section}:{s.name}": s.size
+        for s in link_map.symbols
+        if s.name != s.section and s.size > 0
+    }
+    linked_unreferenced = sorted(
+        {
+            s.name
+            for s in link_map.symbols
+            if link_map.closure
+            and s.name != s.section
+            and s.section in (".init", ".text")
+            and s.name not in link_map.closure
+        }
+    )
+    return {
+        "sections": sections,
+        "symbols": symbols,
+        "total": sum(s.size for s in link_map.sections),
+        "unused": {s.name: s.size for s in link_map.unused},
+        "linked_unreferenced": linked_unreferenced,
+    }
+
+
+def print_report(name: str, report: Dict[str, Any], top: int) -> None:
+    print(f"== {name}")
+    print(f"{'section':<14}{'address':>10}{'size':>10}{'align':>7}{'pad':>8}{'objpad':>8}")
+    for sec_name, sec in report["sections"].items():
+        print(
+            f"{sec_name:<14}{sec['address']:>10x}{sec['size']:>#10x}{sec['align']:>#7x}"
+            f"{sec['align_padding']:>#8x}{sec['object_padding']:>#8x}"
+        )
+    pad = sum(s["align_padding"] + s["object_padding"] for s in report["sections"].values())
+    print(f"total {report['total']:#x} bytes, {pad:#x} bytes of padding")
+
+    print(f"Largest {top} symbols:")
+    for sym, size in sorted(report["symbols"].items(), key=lambda s: -s[1])[:top]:
+        print(f"  {size:>#8x}  {sym}")
+
+    if report["unused"]:
+        print(f"Dead-stripped: {len(report['unused'])} symbols, "
+              f"{sum(report['unused'].values()):#x} bytes")
+    if report["linked_unreferenced"]:
+        print("Linked but unreferenced from __start:")
+        for sym in report["linked_unreferenced"]:
+            print(f"  {sym}")
+    print()
+
+
+def print_diff(name: str, report: Dict[str, Any], baseline: Dict[str, Any]) -> None:
+    changes: List[Tuple[str, int, int]] = []
+    for kind in ("sections", "symbols"):
+        old = baseline.get(kind, {})
+        new = report[kind]
+        for key in sorted(set(old) | set(new)):
+            def size(v: Any) -> int:
+                return v["size"] if isinstance(v, dict) else v
+            before = size(old[key]) if key in old else 0
+            after = size(new[key]) if key in new else 0
+            if before != after:
+                changes.append((key, before, after))
+
+    delta = report["total"] - baseline.get("total", 0)
+    print(f"== {name} vs baseline: {delta:+#x} bytes")
+    for key, before, after in changes:
+        print(f"  {after - before:>+#8x}  {key} ({before:#x} -> {after:#x})")
+    print()
+
+
+def check_budgets(name: str, report: Dict[str, Any], budgets: Dict[str, int]) -> bool:
+    ok = True
+    for key, limit in budgets.items():
+        if key == "total":
+            size = report["total"]
+        elif key in report["sections"]:
+            size = report["sections"][key]["size"]
+        else:
+            continue
+        if size > limit:
+            print(f"{name}: {key} is {size:#x} bytes, over its budget of {limit:#x}")
+            ok = False
+    return ok
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("maps", nargs="+", help="MWLD map files")
+    parser.add_argument("--lcf", default="build/main.lcf", help="linker script the maps were linked with")
+    parser.add_argument("--baseline", help="baseline JSON to diff against")
+    parser.add_argument("--write-baseline", action="store_true", help="store results as the baseline")
+    parser.add_argument(
+        "--budget",
+        action="append",
+        default=[],
+        metavar="SECTION=BYTES",
+        help="maximum size of a section (or 'total')",
+    )
+    parser.add_argument("--top", type=int, default=10, help="largest symbols to list")
+    args = parser.parse_args()
+
+    lcf_align = read_lcf_alignment(args.lcf) if os.path.exists(args.lcf) else {}
+    budgets = {}
+    for budget in args.budget:
+        key, _, value = budget.partition("=")
+        budgets[key] = int(value, 0)
+
+    reports = {path: analyze(parse_map(path), lcf_align) for path in args.maps}
+
+    baseline: Dict[str, Any] = {}
+    if args.baseline and os.path.exists(args.baseline) and not args.write_baseline:
+        with open(args.baseline, "r", encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    ok = True
+    for path, report in reports.items():
+        print_report(path, report, args.top)
+        if path in baseline:
+            print_diff(path, report, baseline[path])
+        ok &= check_budgets(path, report, budgets)
+
+    if args.write_baseline:
+        if not args.baseline:
+            parser.error("--write-baseline requires --baseline")
+        with open(args.baseline, "w", encoding="utf-8") as f:
+            json.dump(reports, f, indent=4, sort_keys=True)
+        print(f"Wrote {args.baseline}")
+
+    if not ok:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+
+###
+# Extracts stack and arena usage from a memory dump.
+#
+# The stats are located through the __mem_stats symbol in the link map;
+# without a map the dump is scanned for their magic instead. The stack
+# high-water mark is re-measured from the painted stack when the map gives
+# its bounds, so a dump taken at any point shows the deepest use so far.
+#
+# Usage:
+#   python3 tools/mem_stats.py mem1.raw --map build/src/target/main.elf.MAP
+###
+
+import argparse
+import json
+import os
+import struct
+import sys
+from typing import Any, Dict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from linkmap import find_in_dump, parse_map
+
+# Must match src/runtime/runtime_mem.h
+MEM_STATS_MAGIC = 0x4D454D53
+MEM_STATS_VERSION = 1
+MEM_STACK_PAINT = 0xCDCDCDCD
+
+STATS = struct.Struct(">7I")
+
+
+def read_stats(dump: bytes, offset: int) -> Dict[str, Any]:
+    magic, version, stack_size, high_water, arena_size, arena_used, arena_peak = STATS.unpack_from(dump, offset)
+    if magic != MEM_STATS_MAGIC:
+        sys.exit(f"Bad magic {magic:#x} at offset {offset:#x}, did __init_mem run?")
+    if version != MEM_STATS_VERSION:
+        sys.exit(f"Unsupported stats version {version}")
+    return {
+        "stack_size": stack_size,
+        "stack_high_water": high_water,
+        "arena_size": arena_size,
+        "arena_used": arena_used,
+        "arena_peak": arena_peak,
+    }
+
+
+def scan_stack(dump: bytes, base: int, lo: int, hi: int) -> int:
+    """Deepest stack use in bytes, from the first overwritten paint word."""
+    lo = (lo + 3) & ~3
+    paint = struct.pack(">I", MEM_STACK_PAINT)
+    for address in range(lo, hi, 4):
+        offset = address - base
+        if dump[offset : offset + 4] != paint:
+            return hi - address
+    return 0
+
+
+def percent(part: int, whole: int) -> str:
+    return f"{part * 100 / whole:5.1f}%" if whole else "    -"
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("dump", help="raw memory dump")
+    parser.add_argument("--map", help="MWLD map of the DOL")
+    parser.add_argument(
+        "--base",
+        type=lambda x: int(x, 0),
+        default=0x80000000,
+        help="address of the first byte of the dump",
+    )
+    parser.add_argument("--json", help="also write the stats to this file")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    link_map = parse_map(args.map) if args.map else None
+    stats = read_stats(dump, find_in_dump(dump, args.base, link_map, "__mem_stats", MEM_STATS_MAGIC, MEM_STATS_VERSION, "Memory stats"))
+
+    if link_map:
+        lo = link_map.symbol("_stack_end")
+        hi = link_map.symbol("_stack_addr")
+        if lo is not None and hi is not None:
+            stats["stack_high_water"] = max(stats["stack_high_water"], scan_stack(dump, args.base, lo, hi))
+
+    print(
+        f"Stack: {stats['stack_high_water']:#x} of {stats['stack_size']:#x} bytes at most"
+        f" ({percent(stats['stack_high_water'], stats['stack_size'])})"
+    )
+    print(
+        f"Arena: {stats['arena_used']:#x} in use, {stats['arena_peak']:#x} peak of {stats['arena_size']:#x} bytes"
+        f" ({percent(stats['arena_peak'], stats['arena_size'])})"
+    )
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(stats, f, indent=4)
+
+
+if __name__ == "__main__":
+    main()
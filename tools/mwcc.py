@@ -0,0 +1,121 @@
+###
+# Helpers for tools that run mwcc outside of ninja.
+#
+# Reads the project configuration from configure.py, builds the same command
+# line the mwcc rule uses and caches objects keyed on compiler version, flags,
+# source text and the headers on the include path.
+###
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import List, Optional, Tuple
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+import configure  # noqa: E402
+from configure import BuildObject  # noqa: E402
+from tools.object_cache import copy_atomic, hash_headers, object_key, object_path, split_flags  # noqa: E402
+
+
+def compiler_exe(version: str) -> Path:
+    return configure.compilers / version / "mwcceppc.exe"
+
+
+def installed_versions() -> List[str]:
+    """COMPILER_MAP versions present in the downloaded compilers."""
+    return [v for v in configure.COMPILER_MAP if compiler_exe(v).exists()]
+
+
+def find_build_object(unit: str) -> BuildObject:
+    for build_object in configure.build_objects:
+        if unit in (build_object.file_path, build_object.name):
+            return build_object
+    names = ", ".join(o.file_path for o in configure.build_objects)
+    raise SystemExit(f"Unknown unit {unit}, expected one of: {names}")
+
+
+def compile_command(version: str, flags: List[str], source: str, output: str) -> List[str]:
+    cmd = []
+    if configure.wrapper is not None:
+        cmd.append(str(configure.wrapper))
+    cmd.append(str(compiler_exe(version)))
+    cmd.extend(split_flags(flags))
+    cmd.extend(["-c", source, "-o", output])
+    return cmd
+
+
+def run_compile(version: str, flags: List[str], source: str, output: str) -> Tuple[bool, str]:
+    result = subprocess.run(
+        compile_command(version, flags, source, output),
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        text=True,
+        errors="replace",
+    )
+    return result.returncode == 0 and os.path.exists(output), result.stdout
+
+
+class CompileCache:
+    """Directory of objects named by a hash of everything that affects them."""
+
+    def __init__(self, directory: Path, flags: List[str]) -> None:
+        self.directory = directory
+        self.directory.mkdir(parents=True, exist_ok=True)
+        # Headers can change codegen, hash them once per run
+        self.headers = hash_headers(flags)
+
+    def key(self, version: str, flags: List[str], source: bytes, source_name: str) -> str:
+        return object_key(version, flags, self.headers, os.path.basename(source_name), source)
+
+    def path(self, key: str) -> Path:
+        return Path(object_path(str(self.directory), key))
+
+    def get(self, key: str) -> Optional[Path]:
+        path = self.path(key)
+        return path if path.exists() else None
+
+    def compile(
+        self, version: str, flags: List[str], source: bytes, source_name: str
+    ) -> Tuple[Optional[Path], str]:
+        """Object for the given source text, compiling it on a cache miss."""
+        key = self.key(version, flags, source, source_name)
+        cached = self.get(key)
+        if cached is not None:
+            return cached, ""
+
+        out = self.path(key)
+        (self.directory / "tmp").mkdir(exist_ok=True)
+        # Other threads and processes may share the directory: compile in a
+        # private scratch directory and only rename complete objects into place
+        work = Path(tempfile.mkdtemp(prefix=f"{key}-", dir=self.directory / "tmp"))
+        obj, log = compile_text(version, flags, source, source_name, work)
+        if obj is None:
+            return None, log
+        work.mkdir(exist_ok=True)
+        (work / "out.o").write_bytes(obj)
+        try:
+            copy_atomic(str(work / "out.o"), str(out))
+        finally:
+            shutil.rmtree(work, ignore_errors=True)
+        return out, log
+
+
+def compile_text(
+    version: str, flags: List[str], source: bytes, source_name: str, work: Path
+) -> Tuple[Optional[bytes], str]:
+    """Compiles source text in a scratch directory and returns the object."""
+    work.mkdir(parents=True, exist_ok=True)
+    # Keep the original file name, mwcc puts it into the object
+    src = work / os.path.basename(source_name)
+    src.write_bytes(source)
+    out = work / "out.o"
+
+    ok, log = run_compile(version, flags, str(src), str(out))
+    obj = out.read_bytes() if ok else None
+    for leftover in work.iterdir():
+        leftover.unlink()
+    work.rmdir()
+    return obj, log
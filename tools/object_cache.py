@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+###
+# Copies objects into and out of the prebuilt object cache.
+#
+# configure.py names every target object in the cache after a hash of its
+# source, the headers on its include path, its flags and the compiler version.
+# When the object is already cached, the build copies it out instead of
+# compiling it. `ninja object_cache` copies freshly compiled objects in, so
+# the directory can be seeded on one machine and reused on others.
+#
+# The key helpers are shared with CompileCache in tools/mwcc.py, which caches
+# the objects compiled by grade.py and compiler_sweep.py the same way.
+#
+# The cache can be shared between builds running at the same time. Files are
+# written under a temporary name and renamed into place, so a reader never
+# sees a partial object.
+#
+# Usage:
+#   python3 tools/object_cache.py build/src/target/foo.o build/object_cache/ab/ab12....o [--stamp file]
+###
+
+import argparse
+import hashlib
+import os
+import shlex
+import shutil
+import sys
+import threading
+from pathlib import Path
+from typing import Iterable, List, Optional, Set
+
+HEADER_SUFFIXES = (".h", ".hpp", ".inc")
+
+
+def split_flags(flags: List[str]) -> List[str]:
+    args: List[str] = []
+    for flag in flags:
+        args.extend(shlex.split(flag))
+    return args
+
+
+def include_dirs(flags: List[str]) -> List[str]:
+    args = split_flags(flags)
+    dirs = []
+    for i, arg in enumerate(args):
+        if arg in ("-i", "-I", "-ir") and i + 1 < len(args):
+            dirs.append(args[i + 1])
+        elif arg.startswith("-I") and len(arg) > 2:
+            dirs.append(arg[2:])
+    return dirs
+
+
+def without_include_paths(flags: List[str]) -> List[str]:
+    """Flags with include directory paths left out, their contents are hashed instead."""
+    args = split_flags(flags)
+    result = []
+    i = 0
+    while i < len(args):
+        if args[i] in ("-i", "-I", "-ir") and i + 1 < len(args):
+            result.append(args[i])
+            i += 1
+        elif args[i].startswith("-I") and len(args[i]) > 2:
+            result.append("-I")
+        else:
+            result.append(args[i])
+        i += 1
+    return result
+
+
+def hash_headers(flags: List[str], files: Optional[Set[str]] = None) -> str:
+    """Hash of the headers on the include path of flags.
+
+    Paths are taken relative to their include directory, so identical trees in
+    different places (one per student in grade.py) share entries. The hashed
+    files are added to files when given.
+    """
+    digest = hashlib.sha256()
+    for index, include_dir in enumerate(include_dirs(flags)):
+        for root, dirs, names in os.walk(include_dir):
+            dirs.sort()
+            for name in sorted(names):
+                if name.endswith(HEADER_SUFFIXES):
+                    path = os.path.join(root, name)
+                    if files is not None:
+                        files.add(path)
+                    digest.update(f"{index}:{os.path.relpath(path, include_dir)}".encode())
+                    with open(path, "rb") as f:
+                        digest.update(hashlib.sha256(f.read()).digest())
+    return digest.hexdigest()
+
+
+def object_key(
+    version: str, flags: List[str], headers: str, source_name: str, source: bytes, extra: Iterable[str] = ()
+) -> str:
+    """Cache key of the object compiled from source.
+
+    headers comes from hash_headers. mwcc records the source name in the
+    object, so it is part of the key.
+    """
+    digest = hashlib.sha256()
+    for part in (version, "\0".join(without_include_paths(flags)), headers, source_name, *extra):
+        digest.update(part.encode())
+        digest.update(b"\0")
+    digest.update(source)
+    return digest.hexdigest()[:32]
+
+
+def object_path(directory: str, key: str) -> str:
+    return os.path.join(directory, key[:2], f"{key}.o")
+
+
+def copy_atomic(src: str, dst: str) -> None:
+    os.makedirs(os.path.dirname(dst) or ".", exist_ok=True)
+    tmp = f"{dst}.{os.getpid()}.{threading.get_ident()}.tmp"
+    try:
+        shutil.copyfile(src, tmp)
+        os.replace(tmp, dst)
+    except BaseException:
+        if os.path.exists(tmp):
+            os.unlink(tmp)
+        raise
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Copy an object into or out of the object cache")
+    parser.add_argument("src")
+    parser.add_argument("dst")
+    parser.add_argument("--stamp", help="touched after the copy, so the copy can be a ninja edge without owning dst")
+    args = parser.parse_args()
+
+    try:
+        copy_atomic(args.src, args.dst)
+        if args.stamp:
+            os.makedirs(os.path.dirname(args.stamp) or ".", exist_ok=True)
+            Path(args.stamp).touch()
+    except OSError as e:
+        sys.exit(f"{args.dst}: {e}")
+
+
+if __name__ == "__main__":
+    main()
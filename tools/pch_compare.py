@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+###
+# Measures compile times with and without precompiled headers.
+#
+# Runs configure.py with and without NO_PCH, cleans every mwcc output and
+# rebuilds the default targets, then compares the wall time and the summed
+# compile (plus precompile) time from .ninja_log. configure.py is re-run with
+# the caller's environment afterwards.
+#
+# Usage:
+#   python3 tools/pch_compare.py [--runs 3] [-j 8]
+###
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import time
+from typing import Dict, List
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from buildstats import PHASES, read_build_graph, read_ninja_log
+
+
+def run(cmd: List[str], env: Dict[str, str]) -> None:
+    result = subprocess.run(cmd, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if result.returncode != 0:
+        sys.exit(f"{' '.join(cmd)} failed:\n{result.stdout}")
+
+
+def measure(ninja: str, use_pch: bool, jobs: List[str]) -> Dict[str, float]:
+    env = dict(os.environ)
+    env["NO_PCH"] = "" if use_pch else "1"
+    run([sys.executable, "configure.py"], env)
+    run([ninja, "-t", "clean", "-r", "mwcc"], env)
+    run([ninja, "-t", "clean", "-r", "mwcc_pch"], env)
+
+    start = time.perf_counter()
+    run([ninja] + jobs, env)
+    wall = time.perf_counter() - start
+
+    graph = read_build_graph("build.ninja")
+    times = {"wall": wall, "compile": 0.0, "pch": 0.0}
+    for entry in read_ninja_log(".ninja_log", set()):
+        edge = graph.get(entry.output)
+        phase = PHASES.get(edge.rule, "") if edge else ""
+        if phase in times:
+            times[phase] += entry.duration / 1000
+    return times
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--runs", type=int, default=3, help="builds per mode, the fastest is kept")
+    parser.add_argument("-j", "--jobs", type=int, help="ninja parallelism")
+    args = parser.parse_args()
+
+    ninja = shutil.which("ninja")
+    if ninja is None:
+        sys.exit("ninja not found")
+    jobs = ["-j", str(args.jobs)] if args.jobs else []
+
+    results: Dict[str, Dict[str, float]] = {}
+    try:
+        for mode, use_pch in (("without", False), ("with", True)):
+            runs = [measure(ninja, use_pch, jobs) for _ in range(args.runs)]
+            results[mode] = min(runs, key=lambda r: r["wall"])
+    finally:
+        run([sys.executable, "configure.py"], dict(os.environ))
+
+    print(f"{'':<10}{'wall':>10}{'compile':>10}{'pch':>10}{'total':>10}")
+    for mode, r in results.items():
+        print(
+            f"{mode + ' PCH':<10}{r['wall']:>9.3f}s{r['compile']:>9.3f}s"
+            f"{r['pch']:>9.3f}s{r['compile'] + r['pch']:>9.3f}s"
+        )
+    before = results["without"]["compile"]
+    after = results["with"]["compile"] + results["with"]["pch"]
+    print(f"Compile time change: {(after - before) * 100 / max(before, 1e-9):+.1f}%")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,324 @@
+#!/usr/bin/env python3
+
+###
+# Searches for source forms of one function that match the target object.
+#
+# Starting from the unit's base source, random mutations are applied to the
+# function body (statement reordering, temporaries, casts, operand swaps,
+# declaration order and register hints). Candidates are compiled in a worker
+# pool with the project's mwcc command line and scored against the target
+# function; the best ones are kept and written out ranked by score.
+#
+# Usage:
+#   python3 tools/permuter.py main_content/01_abi_basics.c call_weird_func_2 --time 300
+###
+
+import argparse
+import hashlib
+import heapq
+import os
+import random
+import re
+import sys
+import threading
+import time
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+from pathlib import Path
+from typing import Callable, Dict, List, NamedTuple, Optional, Set, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import mwcc
+from elffile import ElfFile, Function, function_ratio
+
+TYPE_WORDS = {
+    "int", "short", "long", "char", "float", "double", "unsigned", "signed", "void",
+    "const", "volatile", "register", "static", "struct", "enum", "union",
+    "s8", "s16", "s32", "s64", "u8", "u16", "u32", "u64", "f32", "f64", "BOOL", "Vec3",
+}
+CONTROL_WORDS = ("return", "if", "for", "while", "do", "switch", "goto", "break", "continue", "{")
+COMMUTATIVE = ("+", "*", "&", "|", "^", "==", "!=")
+OPERAND = r"(?:[A-Za-z_]\w*|\d+[uUlLfF]*|0x[0-9a-fA-F]+)"
+
+
+class SourceFunction(NamedTuple):
+    body_start: int
+    body_end: int
+
+
+def find_function(source: str, name: str) -> SourceFunction:
+    """Locates the braces of a function definition by name."""
+    for m in re.finditer(rf"\b{re.escape(name)}\s*\([^;{{)]*\)\s*\{{", source):
+        start = m.end() - 1
+        depth = 0
+        for i in range(start, len(source)):
+            if source[i] == "{":
+                depth += 1
+            elif source[i] == "}":
+                depth -= 1
+                if depth == 0:
+                    return SourceFunction(start + 1, i)
+    raise SystemExit(f"Function {name} not found in source")
+
+
+def split_statements(body: str) -> List[str]:
+    """Top-level statements of a body; nested blocks stay whole."""
+    body = re.sub(r"//[^\n]*|/\*.*?\*/", " ", body, flags=re.S)
+    statements: List[str] = []
+    depth = 0
+    current = ""
+    for c in body:
+        current += c
+        if c in "({[":
+            depth += 1
+        elif c in ")}]":
+            depth -= 1
+            if depth == 0 and c == "}":
+                statements.append(current.strip())
+                current = ""
+        elif c == ";" and depth == 0:
+            statements.append(current.strip())
+            current = ""
+    if current.strip():
+        statements.append(current.strip())
+    return [s for s in statements if s]
+
+
+def is_declaration(statement: str) -> bool:
+    first = re.match(r"[A-Za-z_]\w*", statement)
+    return first is not None and first.group(0) in TYPE_WORDS and "(" not in statement.split("=")[0]
+
+
+def is_plain(statement: str) -> bool:
+    return not is_declaration(statement) and not statement.startswith(CONTROL_WORDS)
+
+
+class Mutator:
+    def __init__(self, rng: random.Random, cast_types: List[str], temp_type: str) -> None:
+        self.rng = rng
+        self.cast_types = cast_types
+        self.temp_type = temp_type
+        self.temp_id = 0
+        self.mutations: List[Callable[[List[str]], Optional[List[str]]]] = [
+            self.swap_statements,
+            self.add_temporary,
+            self.add_cast,
+            self.commute,
+            self.compound_assign,
+            self.swap_declarations,
+            self.register_hint,
+        ]
+
+    def mutate(self, statements: List[str]) -> List[str]:
+        for _ in range(16):
+            result = self.rng.choice(self.mutations)(list(statements))
+            if result is not None and result != statements:
+                return result
+        return statements
+
+    def pick(self, statements: List[str], pred: Callable[[str], bool]) -> Optional[int]:
+        choices = [i for i, s in enumerate(statements) if pred(s)]
+        return self.rng.choice(choices) if choices else None
+
+    def swap_statements(self, s: List[str]) -> Optional[List[str]]:
+        pairs = [i for i in range(len(s) - 1) if is_plain(s[i]) and is_plain(s[i + 1])]
+        if not pairs:
+            return None
+        i = self.rng.choice(pairs)
+        s[i], s[i + 1] = s[i + 1], s[i]
+        return s
+
+    def add_temporary(self, s: List[str]) -> Optional[List[str]]:
+        assign = re.compile(r"^([^=]+?)\s*=(?!=)\s*(.+);$", re.S)
+        i = self.pick(s, lambda x: is_plain(x) and assign.match(x) is not None)
+        if i is None:
+            return None
+        m = assign.match(s[i])
+        assert m
+        self.temp_id += 1
+        t = f"temp_r{self.temp_id}"
+        # Own block so the declaration stays valid C89
+        s[i] = f"{{ {self.temp_type} {t}; {t} = {m.group(2)}; {m.group(1)} = {t}; }}"
+        return s
+
+    def add_cast(self, s: List[str]) -> Optional[List[str]]:
+        i = self.pick(s, lambda x: is_plain(x) and "=" in x)
+        if i is None:
+            return None
+        lhs, _, rhs = s[i].partition("=")
+        names = [m for m in re.finditer(r"(?<![\w)])[A-Za-z_]\w*(?!\s*\()", rhs)]
+        if not names:
+            return None
+        m = self.rng.choice(names)
+        cast = self.rng.choice(self.cast_types)
+        s[i] = f"{lhs}={rhs[: m.start()]}({cast}){m.group(0)}{rhs[m.end() :]}"
+        return s
+
+    def commute(self, s: List[str]) -> Optional[List[str]]:
+        ops = "|".join(re.escape(o) for o in COMMUTATIVE)
+        expr = re.compile(rf"({OPERAND})\s*({ops})(?!=)\s*({OPERAND})")
+        i = self.pick(s, lambda x: expr.search(x) is not None)
+        if i is None:
+            return None
+        matches = list(expr.finditer(s[i]))
+        m = self.rng.choice(matches)
+        s[i] = f"{s[i][: m.start()]}{m.group(3)} {m.group(2)} {m.group(1)}{s[i][m.end() :]}"
+        return s
+
+    def compound_assign(self, s: List[str]) -> Optional[List[str]]:
+        expand = re.compile(r"^(\w+)\s*([-+*/&|^]|<<|>>)=\s*(.+);$")
+        contract = re.compile(r"^(\w+)\s*=\s*(\w+)\s*([-+*/&|^]|<<|>>)\s*([^;]+);$")
+        i = self.pick(s, lambda x: bool(expand.match(x) or contract.match(x)))
+        if i is None:
+            return None
+        m = expand.match(s[i])
+        if m:
+            s[i] = f"{m.group(1)} = {m.group(1)} {m.group(2)} {m.group(3)};"
+            return s
+        m = contract.match(s[i])
+        if m and m.group(1) == m.group(2):
+            s[i] = f"{m.group(1)} {m.group(3)}= {m.group(4)};"
+            return s
+        return None
+
+    def swap_declarations(self, s: List[str]) -> Optional[List[str]]:
+        # Declaration order changes how mwcc assigns registers
+        pairs = [i for i in range(len(s) - 1) if is_declaration(s[i]) and is_declaration(s[i + 1])]
+        if not pairs:
+            return None
+        i = self.rng.choice(pairs)
+        s[i], s[i + 1] = s[i + 1], s[i]
+        return s
+
+    def register_hint(self, s: List[str]) -> Optional[List[str]]:
+        i = self.pick(s, is_declaration)
+        if i is None:
+            return None
+        if s[i].startswith("register "):
+            s[i] = s[i][len("register ") :]
+        else:
+            s[i] = "register " + s[i]
+        return s
+
+
+class Candidate(NamedTuple):
+    score: float
+    statements: Tuple[str, ...]
+
+
+def render(source: str, func: SourceFunction, statements: Tuple[str, ...]) -> str:
+    body = "".join(f"\n    {st}" for st in statements) + "\n"
+    return source[: func.body_start] + body + source[func.body_end :]
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("unit", help="BuildObject path, e.g. main_content/01_abi_basics.c")
+    parser.add_argument("function", help="function to permute")
+    parser.add_argument("--target", help="object to match (default: the unit's target object)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--time", type=float, default=60.0, help="seconds to search")
+    parser.add_argument("--keep", type=int, default=10, help="best candidates to keep")
+    parser.add_argument("--seed", type=int, help="random seed")
+    parser.add_argument("--casts", default="int,u32,s32,u8,s16", help="cast types to try")
+    parser.add_argument("--temp-type", default="int", help="type of introduced temporaries")
+    parser.add_argument("--out", type=Path, help="output directory for ranked candidates")
+    args = parser.parse_args()
+
+    build_object = mwcc.find_build_object(args.unit)
+    version = build_object.options["mw_version"]
+    flags = mwcc.configure.BASE_MWCC_FLAGS
+    source_path = os.path.join("src", build_object.base_path)
+    target = args.target or os.path.join(mwcc.configure.target_build_dir, build_object.target_obj)
+    if not os.path.exists(target):
+        sys.exit(f"{target} not found, build it with ninja first")
+    target_func = ElfFile.read(target).functions().get(args.function)
+    if target_func is None:
+        sys.exit(f"{args.function} not in {target}")
+
+    with open(source_path, "r", encoding="utf-8") as f:
+        source = f.read()
+    func = find_function(source, args.function)
+    base = tuple(split_statements(source[func.body_start : func.body_end]))
+
+    out_dir = args.out or mwcc.configure.build_dir / "permuter" / args.function
+    out_dir.mkdir(parents=True, exist_ok=True)
+    work_root = out_dir / "work"
+    rng = random.Random(args.seed)
+    mutator = Mutator(rng, args.casts.split(","), args.temp_type)
+
+    def evaluate(statements: Tuple[str, ...]) -> Optional[float]:
+        text = render(source, func, statements).encode()
+        key = hashlib.sha256(text).hexdigest()[:16]
+        work = work_root / f"{threading.get_ident()}_{key}"
+        obj, _ = mwcc.compile_text(version, flags, text, source_path, work)
+        if obj is None:
+            return None
+        cand: Optional[Function] = ElfFile(obj).functions().get(args.function)
+        return function_ratio(target_func, cand)
+
+    base_score = evaluate(base)
+    if base_score is None:
+        sys.exit(f"{source_path} does not compile")
+    print(f"Base score {base_score * 100:.2f}%")
+
+    best: List[Candidate] = [Candidate(base_score, base)]
+    seen: Set[Tuple[str, ...]] = {base}
+    compiled = failed = 0
+    start = time.monotonic()
+    deadline = start + args.time
+
+    def next_candidate() -> Tuple[str, ...]:
+        # Mostly refine the leaders, sometimes restart from the original
+        parent = base if rng.random() < 0.1 else rng.choice(best).statements
+        statements = list(parent)
+        for _ in range(rng.choice((1, 1, 2, 3))):
+            statements = mutator.mutate(statements)
+        return tuple(statements)
+
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        pending: Dict[Future, Tuple[str, ...]] = {}
+        while time.monotonic() < deadline and best[0].score < 1.0:
+            attempts = 0
+            while len(pending) < args.jobs * 2 and attempts < 1000:
+                attempts += 1
+                cand = next_candidate()
+                if cand in seen:
+                    continue
+                seen.add(cand)
+                pending[pool.submit(evaluate, cand)] = cand
+            if not pending:
+                print("Search space exhausted")
+                break
+
+            done, _ = wait(pending, timeout=1.0, return_when=FIRST_COMPLETED)
+            for fut in done:
+                cand = pending.pop(fut)
+                score = fut.result()
+                compiled += 1
+                if score is None:
+                    failed += 1
+                    continue
+                if len(best) < args.keep or score > best[-1].score:
+                    if score > best[0].score:
+                        print(f"[{time.monotonic() - start:7.1f}s] new best {score * 100:.2f}%")
+                    best.append(Candidate(score, cand))
+                    best = heapq.nlargest(args.keep, best, key=lambda c: c.score)
+
+        for fut in pending:
+            fut.cancel()
+    if work_root.exists() and not any(work_root.iterdir()):
+        work_root.rmdir()
+
+    elapsed = time.monotonic() - start
+    print(
+        f"{compiled} candidates in {elapsed:.1f}s ({compiled / max(elapsed, 1e-9):.1f}/s "
+        f"on {args.jobs} workers), {failed} failed to compile"
+    )
+    for rank, cand in enumerate(best):
+        path = out_dir / f"{rank:02d}_{cand.score * 100:06.2f}.c"
+        path.write_text(render(source, func, cand.statements), encoding="utf-8")
+        print(f"  {cand.score * 100:6.2f}%  {path}")
+
+
+if __name__ == "__main__":
+    main()
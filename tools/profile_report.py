@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+
+###
+# Reports per-function call counts and time from a memory dump of the
+# profiling DOL (`ninja profile`).
+#
+# The table is located through the __profile_table symbol in the link map;
+# without a map the dump is scanned for its magic instead. Functions are
+# named by the string mwcc passes to the entry hook, or by the link map
+# symbol containing the recorded return address.
+#
+# Usage:
+#   python3 tools/profile_report.py mem1.raw --map build/src/profile/main.elf.MAP
+###
+
+import argparse
+import json
+import os
+import struct
+import sys
+from typing import Any, Dict, List, Optional
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from linkmap import DumpSymbols, LinkMap, find_in_dump, parse_map
+
+# Must match src/shared/profile.h
+PROFILE_MAGIC = 0x50524F46
+PROFILE_VERSION = 1
+
+HEADER = struct.Struct(">4I")
+ENTRY = struct.Struct(">4I2Q")
+
+# Time base ticks -> Gekko CPU cycles
+TICKS_TO_CYCLES = 12
+
+
+def read_profile(dump: bytes, base: int, offset: int, link_map: Optional[LinkMap]) -> Dict[str, Any]:
+    symbols = DumpSymbols(dump, base, link_map)
+    magic, version, capacity, dropped = HEADER.unpack_from(dump, offset)
+    if magic != PROFILE_MAGIC:
+        sys.exit(f"Bad magic {magic:#x} at offset {offset:#x}, is this the profiling DOL?")
+    if version != PROFILE_VERSION:
+        sys.exit(f"Unsupported table version {version}")
+
+    functions: List[Dict[str, Any]] = []
+    for i in range(capacity):
+        key, pc, calls, _, inclusive, exclusive = ENTRY.unpack_from(dump, offset + HEADER.size + i * ENTRY.size)
+        if key == 0:
+            continue
+        function = symbols.containing(pc)
+        name = symbols.string(key) or (function.name if function else f"{pc:#x}")
+        functions.append(
+            {
+                "name": name,
+                "pc": pc,
+                "calls": calls,
+                "inclusive": inclusive,
+                "exclusive": exclusive,
+            }
+        )
+    functions.sort(key=lambda f: f["exclusive"], reverse=True)
+    return {"dropped": dropped, "functions": functions}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("dump", help="raw memory dump")
+    parser.add_argument("--map", help="MWLD map of the profiling DOL")
+    parser.add_argument(
+        "--base",
+        type=lambda x: int(x, 0),
+        default=0x80000000,
+        help="address of the first byte of the dump",
+    )
+    parser.add_argument("--json", help="also write results to this file")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    link_map = parse_map(args.map) if args.map else None
+    profile = read_profile(dump, args.base, find_in_dump(dump, args.base, link_map, "__profile_table", PROFILE_MAGIC, PROFILE_VERSION, "Profile table"), link_map)
+
+    total = sum(f["exclusive"] for f in profile["functions"]) or 1
+    print(f"{'function':<32}{'calls':>10}{'incl cycles':>14}{'excl cycles':>14}{'excl %':>8}{'cycles/call':>13}")
+    for f in profile["functions"]:
+        per_call = f["inclusive"] * TICKS_TO_CYCLES // max(f["calls"], 1)
+        print(
+            f"{f['name']:<32}{f['calls']:>10}{f['inclusive'] * TICKS_TO_CYCLES:>14}"
+            f"{f['exclusive'] * TICKS_TO_CYCLES:>14}{f['exclusive'] * 100 / total:>7.1f}%{per_call:>13}"
+        )
+    if profile["dropped"]:
+        print(f"{profile['dropped']} calls dropped, raise PROFILE_MAX_FUNCS")
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(profile, f, indent=4)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+###
+# Keeps the main DOL symbols that REL modules import from being dead-stripped.
+#
+# Collects the symbols the module objects reference but none of them define
+# and appends them to a copy of the main linker script as a FORCEACTIVE list,
+# so mwld keeps them in main.elf even when nothing in the DOL calls them.
+# Symbols mwld generates for the partial link (_ctors, _f_text, ...) are left
+# out since they resolve inside the module.
+#
+# Usage:
+#   python3 tools/rel_exports.py build/main.lcf module.o... -o build/src/target/main_modules.lcf
+###
+
+import argparse
+import os
+import sys
+from typing import List, Set
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from elffile import ElfFile
+
+SHN_UNDEF = 0
+STB_LOCAL = 0
+
+# Defined by mwld in the module's partial link
+LINKER_SYMBOLS = {"_ctors", "_dtors", "_eti_init_info", "_rom_copy_info", "_bss_init_info"}
+LINKER_PREFIXES = ("_f_", "_e_")
+
+
+def module_imports(paths: List[str]) -> List[str]:
+    defined: Set[str] = set()
+    referenced: Set[str] = set()
+    for path in paths:
+        elf = ElfFile.read(path)
+        for sym in elf.symbols:
+            if not sym.name or sym.bind == STB_LOCAL:
+                continue
+            if sym.shndx == SHN_UNDEF:
+                referenced.add(sym.name)
+            else:
+                defined.add(sym.name)
+
+    return sorted(
+        name
+        for name in referenced - defined
+        if name not in LINKER_SYMBOLS and not name.startswith(LINKER_PREFIXES)
+    )
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Add the symbols REL modules import to FORCEACTIVE")
+    parser.add_argument("lcf", help="linker script of the main DOL")
+    parser.add_argument("objects", nargs="+", help="objects linked into REL modules")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    with open(args.lcf, encoding="utf-8") as f:
+        lcf = f.read()
+
+    imports = module_imports(args.objects)
+    if imports:
+        lcf = lcf.rstrip("\n") + "\n\nFORCEACTIVE\n{\n" + "".join(f"    {name}\n" for name in imports) + "}\n"
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(lcf)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+
+###
+# Computes the worst-case stack depth of a linked ELF.
+#
+# Builds the call graph from `bl` and tail-call `b` instructions, takes each
+# function's frame size from its `stwu r1` (or `stwux r1,r1,r12`) prologue
+# and finds the deepest path from __start. Indirect calls (bctrl/blrl) are
+# assumed to reach any function whose address is stored in data or built in
+# code with lis/addi (or lis/ori), and recursion is reported since its depth
+# cannot be bounded statically.
+#
+# With --write, the recommended stack size is stored for configure.py, which
+# uses it for _stack_addr in the generated linker script.
+#
+# Usage:
+#   python3 tools/stack_depth.py build/src/target/main.elf --write build/stack_size.json
+#
+# When recursion, an unknown frame size or a call outside the known functions
+# makes the result a lower bound, it
+# is only written with --force or with --min giving a size known to be safe.
+###
+
+import argparse
+import json
+import os
+import struct
+import sys
+from typing import Dict, List, NamedTuple, Optional, Set, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from elffile import SHF_EXECINSTR, SHT_NOBITS, ElfFile
+
+BCTRL = 0x4E800421
+BLRL = 0x4E800021
+
+
+class FuncInfo(NamedTuple):
+    name: str
+    address: int
+    frame: int
+    dynamic: bool  # Frame size could not be determined
+    calls: Set[int]
+    tail_calls: Set[int]
+    indirect: bool
+
+
+def sign_extend(value: int, bits: int) -> int:
+    sign = 1 << (bits - 1)
+    return (value & (sign - 1)) - (value & sign)
+
+
+def frame_size(words: List[int]) -> Tuple[int, bool]:
+    for i, w in enumerate(words):
+        # stwu r1, -N(r1)
+        if w >> 16 == 0x9421:
+            return -sign_extend(w & 0xFFFF, 16), False
+        # stwux r1, r1, r12 with r12 loaded by li or lis/ori just before
+        if w == 0x7C21616E:
+            value: Optional[int] = None
+            for prev in words[max(i - 3, 0) : i]:
+                if prev >> 16 == 0x3980:  # li r12, imm
+                    value = sign_extend(prev & 0xFFFF, 16)
+                elif prev >> 16 == 0x3D80:  # lis r12, imm
+                    value = sign_extend(prev & 0xFFFF, 16) << 16
+                elif prev >> 16 == 0x618C and value is not None:  # ori r12, r12, imm
+                    value |= prev & 0xFFFF
+            if value is not None:
+                return -value, False
+            return 0, True
+    return 0, False
+
+
+def code_addresses(words: List[int], starts: Dict[int, str]) -> Set[int]:
+    # Function addresses built with lis rX,hi followed by addi/ori rY,rX,lo,
+    # e.g. callbacks passed as arguments. A lis value is kept until the
+    # register gets another lis, which can only add targets.
+    found: Set[int] = set()
+    high: Dict[int, int] = {}
+    for w in words:
+        op = w >> 26
+        rd = (w >> 21) & 31
+        ra = (w >> 16) & 31
+        value: Optional[int] = None
+        if op == 15 and ra == 0:  # lis rd, imm
+            high[rd] = (w & 0xFFFF) << 16
+        elif op == 14 and ra != 0 and ra in high:  # addi rd, ra, imm
+            value = (high[ra] + sign_extend(w & 0xFFFF, 16)) & 0xFFFFFFFF
+        elif op == 24 and rd in high:  # ori ra, rs, imm (rs in the rd field)
+            value = high[rd] | (w & 0xFFFF)
+        if value is not None and value in starts:
+            found.add(value)
+    return found
+
+
+def analyze(elf: ElfFile) -> Dict[int, FuncInfo]:
+    funcs = elf.functions()
+    starts = {f.address: name for name, f in funcs.items()}
+
+    # Function addresses stored in data or built in code are potential
+    # indirect call targets
+    address_taken: Set[int] = set()
+    for sec in elf.sections:
+        if sec.addr == 0 or sec.type == SHT_NOBITS or sec.flags & SHF_EXECINSTR:
+            continue
+        data = elf.section_data(sec)
+        for (word,) in struct.iter_unpack(">I", data[: len(data) & ~3]):
+            if word in starts:
+                address_taken.add(word)
+
+    code: Dict[str, List[int]] = {}
+    for name, func in funcs.items():
+        code[name] = [w for (w,) in struct.iter_unpack(">I", func.code[: len(func.code) & ~3])]
+        address_taken |= code_addresses(code[name], starts)
+
+    result: Dict[int, FuncInfo] = {}
+    for name, func in funcs.items():
+        words = code[name]
+        frame, dynamic = frame_size(words)
+        calls: Set[int] = set()
+        tail_calls: Set[int] = set()
+        indirect = False
+        for i, w in enumerate(words):
+            pc = func.address + i * 4
+            if w >> 26 == 18:
+                target = sign_extend(w & 0x03FFFFFC, 26)
+                if not w & 2:
+                    target += pc
+                target &= 0xFFFFFFFF
+                if w & 1:
+                    calls.add(target)
+                elif not func.address <= target < func.address + len(func.code):
+                    tail_calls.add(target)
+            elif w in (BCTRL, BLRL):
+                indirect = True
+        if indirect:
+            calls |= address_taken
+        result[func.address] = FuncInfo(name, func.address, frame, dynamic, calls, tail_calls, indirect)
+    return result
+
+
+class Report(NamedTuple):
+    depth: int
+    path: List[str]
+    recursive: List[str]
+    indirect: List[str]
+    dynamic: List[str]
+    unknown: List[int]
+
+
+def worst_case(funcs: Dict[int, FuncInfo], root: int) -> Report:
+    memo: Dict[int, Tuple[int, List[str]]] = {}
+    active: Set[int] = set()
+    recursive: Set[str] = set()
+    unknown: Set[int] = set()
+    reached: Set[int] = set()
+
+    # Returns the depth, its path and the active callers whose recursion was
+    # cut below addr. A result that depends on such a cut only holds for this
+    # call path, so it is only memoized once no cut reaches above addr.
+    def visit(addr: int) -> Tuple[int, List[str], Set[int]]:
+        if addr in memo:
+            return memo[addr] + (set(),)
+        func = funcs.get(addr)
+        if func is None:
+            unknown.add(addr)
+            return 0, [], set()
+        if addr in active:
+            recursive.add(func.name)
+            return 0, [], {addr}
+
+        active.add(addr)
+        reached.add(addr)
+        cuts: Set[int] = set()
+        best, best_path = 0, []
+        for callee in func.calls:
+            depth, path, cut = visit(callee)
+            cuts |= cut
+            if depth > best:
+                best, best_path = depth, path
+        own = func.frame + best
+        own_path = [func.name] + best_path
+        # A tail call runs after this frame has been popped
+        for callee in func.tail_calls:
+            depth, path, cut = visit(callee)
+            cuts |= cut
+            if depth > own:
+                own, own_path = depth, [func.name + " (tail)"] + path
+        active.discard(addr)
+
+        cuts.discard(addr)
+        if not cuts:
+            memo[addr] = (own, own_path)
+        return own, own_path, cuts
+
+    depth, path, _ = visit(root)
+    return Report(
+        depth,
+        path,
+        sorted(recursive),
+        sorted(funcs[a].name for a in reached if a in funcs and funcs[a].indirect),
+        sorted(funcs[a].name for a in reached if a in funcs and funcs[a].dynamic),
+        sorted(unknown),
+    )
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("elfs", nargs="+", help="linked ELF files")
+    parser.add_argument("--root", action="append", help="entry points (default: __start)")
+    parser.add_argument(
+        "--margin",
+        type=lambda x: int(x, 0),
+        default=0x400,
+        help="bytes added for interrupts and other unseen callers",
+    )
+    parser.add_argument("--write", help="store the recommended stack size for configure.py")
+    parser.add_argument(
+        "--min",
+        type=lambda x: int(x, 0),
+        help="smallest stack size to write, allows writing a result that is only a lower bound",
+    )
+    parser.add_argument(
+        "--force",
+        action="store_true",
+        help="write the recommended size even if it is only a lower bound",
+    )
+    args = parser.parse_args()
+
+    required = 0
+    uncertain = False
+    for path in args.elfs:
+        elf = ElfFile.read(path)
+        funcs = analyze(elf)
+        by_name = {f.name: a for a, f in funcs.items()}
+        print(f"== {path}")
+        for root in args.root or ["__start"]:
+            if root not in by_name:
+                sys.exit(f"{root} not found in {path}")
+            report = worst_case(funcs, by_name[root])
+            print(f"Worst-case stack from {root}: {report.depth:#x} bytes")
+            for name in report.path:
+                func = funcs[by_name[name.split(" ")[0]]]
+                print(f"  {func.frame:>#8x}  {name}")
+            if report.recursive:
+                uncertain = True
+                print(f"Recursion (depth not bounded): {', '.join(report.recursive)}")
+            if report.indirect:
+                print(f"Indirect calls (assumed to reach address-taken functions): {', '.join(report.indirect)}")
+            if report.dynamic:
+                uncertain = True
+                print(f"Unknown frame size: {', '.join(report.dynamic)}")
+            if report.unknown:
+                uncertain = True
+                print(f"Calls outside known functions: {', '.join(hex(a) for a in report.unknown)}")
+            required = max(required, report.depth)
+        print()
+
+    # Stack grows down from _stack_addr; rounding to 0x100 keeps it well past
+    # the 8-byte alignment the EABI needs
+    recommended = (required + args.margin + 0xFF) & ~0xFF
+    print(f"Recommended stack size: {recommended:#x} ({required:#x} + {args.margin:#x} margin)")
+    if uncertain:
+        print("Warning: recursion, dynamic frames or unknown calls found, the result is a lower bound")
+
+    if args.write:
+        stack_size = max(recommended, args.min or 0)
+        # configure.py ignores an uncertain size unless it was asked for explicitly
+        forced = uncertain and (args.force or args.min is not None)
+        if uncertain and not forced:
+            sys.exit(f"Not writing {args.write}: the stack size is only a lower bound, pass --min or --force to write it anyway")
+        with open(args.write, "w", encoding="utf-8") as f:
+            json.dump(
+                {"stack_size": stack_size, "required": required, "uncertain": uncertain, "forced": forced},
+                f,
+                indent=4,
+            )
+        print(f"Wrote {stack_size:#x} to {args.write}, re-run configure.py to apply it")
+
+
+if __name__ == "__main__":
+    main()
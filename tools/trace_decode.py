@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+
+###
+# Converts the TRACE_BEGIN/TRACE_END ring buffer in a memory dump to Chrome
+# trace JSON (chrome://tracing, Perfetto).
+#
+# The buffer is located through the __trace_buffer symbol in the link map;
+# without a map the dump is scanned for its magic instead. Event ids are
+# named by, in order: --names, a link map symbol starting at the id, a
+# NUL-terminated string at the id in the dump (for string literal ids) and
+# the symbol containing the id.
+#
+# Usage:
+#   python3 tools/trace_decode.py mem1.raw --map build/src/target/main.elf.MAP -o trace.json
+###
+
+import argparse
+import json
+import os
+import struct
+import sys
+from typing import Any, Dict, List, Optional, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from linkmap import DumpSymbols, LinkMap, find_in_dump, parse_map
+
+# Must match src/runtime/trace.h
+TRACE_MAGIC = 0x54524345
+TRACE_VERSION = 1
+TRACE_END_FLAG = 0x80000000
+
+HEADER = struct.Struct(">5I")
+EVENT = struct.Struct(">2I")
+
+# GC time base, 1/4 of the 162 MHz bus clock
+TIME_BASE_HZ = 40_500_000
+
+
+class Resolver(DumpSymbols):
+    def __init__(self, dump: bytes, base: int, link_map: Optional[LinkMap], names: Dict[int, str]) -> None:
+        super().__init__(dump, base, link_map)
+        self.names = names
+
+    def __call__(self, event_id: int) -> str:
+        if event_id in self.names:
+            return self.names[event_id]
+        # String literals live inside other symbols, so only a symbol's start
+        # is preferred over reading a string. Compiler-generated symbols like
+        # @stringBase0 start at the first literal of a pool and don't count.
+        exact = self.symbol(event_id, True)
+        if exact and not exact.startswith("@"):
+            return exact
+        return self.string(event_id) or exact or self.symbol(event_id, False) or f"{event_id:#x}"
+
+
+def read_events(dump: bytes, offset: int) -> List[Tuple[int, bool, int]]:
+    """(ticks since the oldest kept event, is end, id), oldest first."""
+    magic, version, capacity, head, _ = HEADER.unpack_from(dump, offset)
+    if magic != TRACE_MAGIC:
+        sys.exit(f"Bad magic {magic:#x} at offset {offset:#x}, was trace_reset() called?")
+    if version != TRACE_VERSION:
+        sys.exit(f"Unsupported trace version {version}")
+
+    count = min(head, capacity)
+    events = []
+    time = 0
+    for i in range(head - count, head):
+        delta, event_id = EVENT.unpack_from(dump, offset + HEADER.size + (i % capacity) * EVENT.size)
+        # The oldest kept delta refers to an overwritten event
+        if events:
+            time += delta & ~TRACE_END_FLAG
+        events.append((time, bool(delta & TRACE_END_FLAG), event_id))
+    return events
+
+
+def chrome_trace(events: List[Tuple[int, bool, int]], resolve: Resolver, tick_hz: int) -> Dict[str, Any]:
+    trace: List[Dict[str, Any]] = []
+    open_ids: List[int] = []
+    for time, end, event_id in events:
+        if end:
+            # Its begin was overwritten when the ring wrapped
+            if event_id not in open_ids:
+                continue
+            # Close anything left open inside it so B/E stay nested
+            while open_ids:
+                inner = open_ids.pop()
+                trace.append({"name": resolve(inner), "ph": "E", "ts": time * 1e6 / tick_hz, "pid": 0, "tid": 0})
+                if inner == event_id:
+                    break
+        else:
+            open_ids.append(event_id)
+            trace.append({"name": resolve(event_id), "ph": "B", "ts": time * 1e6 / tick_hz, "pid": 0, "tid": 0})
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("dump", help="raw memory dump")
+    parser.add_argument("--map", help="MWLD map of the DOL")
+    parser.add_argument(
+        "--base",
+        type=lambda x: int(x, 0),
+        default=0x80000000,
+        help="address of the first byte of the dump",
+    )
+    parser.add_argument("--names", help='JSON object of extra id names, e.g. {"0x10": "frame"}')
+    parser.add_argument(
+        "--tick-rate",
+        type=int,
+        default=TIME_BASE_HZ,
+        help="ticks per second (1000000000 for native builds)",
+    )
+    parser.add_argument("-o", "--output", default="trace.json", help="Chrome trace JSON to write")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    names: Dict[int, str] = {}
+    if args.names:
+        with open(args.names, encoding="utf-8") as f:
+            names = {int(k, 0): v for k, v in json.load(f).items()}
+
+    link_map = parse_map(args.map) if args.map else None
+    events = read_events(dump, find_in_dump(dump, args.base, link_map, "__trace_buffer", TRACE_MAGIC, TRACE_VERSION, "Trace buffer"))
+    trace = chrome_trace(events, Resolver(dump, args.base, link_map, names), args.tick_rate)
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        json.dump(trace, f, indent=1)
+    print(f"{len(events)} events, {len(trace['traceEvents'])} written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()